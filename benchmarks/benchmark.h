@@ -0,0 +1,64 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+namespace core::benchmark
+{
+    namespace detail
+    {
+        inline const volatile void* sink{};
+    }
+
+    /**
+     * @brief Forces the compiler to keep the computation of the specified value.
+    */
+    template <typename T>
+    void DoNotOptimize(const T& value)
+    {
+        detail::sink = &value;
+    }
+
+    /**
+     * @brief Runs \c func(i) \c iterations times after a short warm-up and prints the average time per call.
+     *
+     * @return The average time per call in nanoseconds.
+    */
+    template <typename Func>
+    double Measure(const char* const name, const std::size_t iterations, Func&& func)
+    {
+        for (std::size_t i = 0; i < iterations / 10; ++i) {
+            func(i);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+
+        for (std::size_t i = 0; i < iterations; ++i) {
+            func(i);
+        }
+
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        const auto result = elapsed.count() / static_cast<double>(iterations);
+        std::printf("%-48s %10.2f ns/op\n", name, result);
+
+        return result;
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "benchmark.h"
+#include <core/strings/fixed_string.h>
+#include <core/strings/format.h>
+#include <cstdio>
+#include <string>
+#include <utility>
+
+using namespace core;
+
+namespace
+{
+    /**
+     * @brief The previous implementation of str::Format: one snprintf call to get the size, one to write.
+    */
+    template <typename... Args>
+    std::string LegacyFormat(const std::string& format, Args&&... args)
+    {
+        std::string string{};
+        const auto required = std::snprintf(nullptr, 0, format.c_str(), str::detail::Cast(args)...);
+
+        if (required > 0) {
+            string.resize(static_cast<std::string::size_type>(required), str::EOS);
+            std::snprintf(string.data(), required + 1, format.c_str(), str::detail::Cast(std::forward<Args>(args))...);
+        }
+
+        return string;
+    }
+
+    const std::string KILLER = "the_hunter";
+    const std::string VICTIM = "Player";
+    const std::string FORMAT = "%s killed %s with %s (%d hp left)";
+}
+
+int main()
+{
+    constexpr std::size_t iterations = 2'000'000;
+
+    benchmark::Measure("legacy Format (2x snprintf, std::string)", iterations, [](const std::size_t i) {
+        const auto result = LegacyFormat(FORMAT, KILLER, VICTIM, "ak47", static_cast<int>(i & 0x7F));
+        benchmark::DoNotOptimize(result);
+    });
+
+    benchmark::Measure("str::Format (stack buffer, std::string)", iterations, [](const std::size_t i) {
+        const auto result = str::Format(FORMAT, KILLER, VICTIM, "ak47", static_cast<int>(i & 0x7F));
+        benchmark::DoNotOptimize(result);
+    });
+
+    benchmark::Measure("str::Format (CORE_FORMAT)", iterations, [](const std::size_t i) {
+        const auto result = str::Format(CORE_FORMAT("%s killed %s with %s (%d hp left)"),
+                                        KILLER, VICTIM, "ak47", static_cast<int>(i & 0x7F));
+        benchmark::DoNotOptimize(result);
+    });
+
+    benchmark::Measure("str::FormatTo (char[190])", iterations, [](const std::size_t i) {
+        char buffer[190];
+        str::FormatTo(buffer, FORMAT.c_str(), KILLER, VICTIM, "ak47", static_cast<int>(i & 0x7F));
+        benchmark::DoNotOptimize(buffer);
+    });
+
+    return 0;
+}
@@ -0,0 +1,107 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "benchmark.h"
+#include <core/delegate.h>
+#include <core/inplace_function.h>
+#include <core/observer.h>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+using namespace core;
+
+namespace
+{
+    std::uint64_t counter{};
+
+    void OnEvent(const int value)
+    {
+        counter += static_cast<std::uint64_t>(value);
+    }
+
+    struct Listener
+    {
+        std::uint64_t total{};
+
+        void OnEvent(const int value)
+        {
+            total += static_cast<std::uint64_t>(value);
+        }
+    };
+
+    class Event : public Observable<int>
+    {
+    public:
+        using Observable::Notify;
+    };
+
+    constexpr std::size_t CALLABLES = 1000;
+
+    /**
+     * @brief Calls every callable of the array once per iteration and prints the time per call.
+    */
+    template <typename Callable>
+    void Run(const char* const name, const std::vector<Callable>& callables)
+    {
+        const auto ns = benchmark::Measure(name, 20'000, [&callables](const std::size_t i) {
+            for (const auto& callable : callables) {
+                callable(static_cast<int>(i & 1));
+            }
+        });
+
+        std::printf("%-48s %10.2f ns/call\n", "  per call", ns / static_cast<double>(callables.size()));
+    }
+}
+
+int main()
+{
+    std::vector<Listener> listeners(CALLABLES);
+
+    std::vector<void (*)(int)> pointers(CALLABLES, &OnEvent);
+    std::vector<Delegate<void(int)>> delegates{};
+    std::vector<std::function<void(int)>> functions{};
+    std::vector<InplaceFunction<void(int)>> inplace_lambdas{};
+    std::vector<InplaceFunction<void(int)>> inplace_delegates{};
+    Event event{};
+    std::vector<Subscription> subscriptions{};
+
+    for (auto& listener : listeners) {
+        delegates.emplace_back(DELEGATE_ARG<&Listener::OnEvent>, &listener);
+        functions.emplace_back([&listener](const int value) { listener.OnEvent(value); });
+        inplace_lambdas.emplace_back([&listener](const int value) { listener.OnEvent(value); });
+        inplace_delegates.emplace_back(Delegate<void(int)>{DELEGATE_ARG<&Listener::OnEvent>, &listener});
+        subscriptions.push_back(event.Subscribe<&Listener::OnEvent>(&listener));
+    }
+
+    Run("function pointer (1000 calls)", pointers);
+    Run("Delegate (1000 calls)", delegates);
+    Run("std::function, lambda (1000 calls)", functions);
+    Run("InplaceFunction, lambda (1000 calls)", inplace_lambdas);
+    Run("InplaceFunction, Delegate (1000 calls)", inplace_delegates);
+
+    const auto ns = benchmark::Measure("Observable::Notify, Delegate (1000 observers)", 20'000, [&event](const std::size_t i) {
+        event.Notify(static_cast<int>(i & 1));
+    });
+
+    std::printf("%-48s %10.2f ns/call\n", "  per call", ns / static_cast<double>(CALLABLES));
+
+    benchmark::DoNotOptimize(counter);
+    benchmark::DoNotOptimize(listeners);
+    return 0;
+}
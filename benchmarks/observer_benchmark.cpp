@@ -0,0 +1,133 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "benchmark.h"
+#include <core/delegate.h>
+#include <core/observer.h>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace core;
+
+namespace
+{
+    /**
+     * @brief The previous Observable: a vector of (id, delegate) pairs, unsubscribe erases by a linear search.
+    */
+    class LegacyObservable
+    {
+        std::int32_t next_id_{};
+        std::vector<std::pair<std::int32_t, Delegate<void(int)>>> observers_{};
+
+    public:
+        std::int32_t Subscribe(Delegate<void(int)>&& observer)
+        {
+            observers_.emplace_back(next_id_++, std::move(observer));
+            return observers_.back().first;
+        }
+
+        void Unsubscribe(const std::int32_t id)
+        {
+            observers_.erase(std::remove_if(observers_.begin(), observers_.end(),
+                                            [id](const auto& element) { return element.first == id; }),
+                             observers_.end());
+        }
+
+        void Notify(int&& value) const
+        {
+            for (const auto& observer : observers_) {
+                observer.second(value);
+            }
+        }
+    };
+
+    class Event : public Observable<int>
+    {
+    public:
+        using Observable::Notify;
+    };
+
+    std::uint64_t counter{};
+
+    void OnEvent(const int value)
+    {
+        counter += static_cast<std::uint64_t>(value);
+    }
+
+    constexpr std::size_t SUBSCRIBERS = 5000;
+    constexpr std::size_t CHURN = 100;
+}
+
+int main()
+{
+    constexpr std::size_t frames = 2'000;
+
+    {
+        LegacyObservable observable{};
+        std::vector<std::int32_t> ids{};
+        std::mt19937 random{1}; // NOLINT(cert-msc51-cpp)
+
+        for (std::size_t i = 0; i < SUBSCRIBERS; ++i) {
+            ids.push_back(observable.Subscribe(DELEGATE_ARG<&OnEvent>));
+        }
+
+        benchmark::Measure("legacy Observable, frame (5000 subs, 100 churn)", frames, [&](const std::size_t) {
+            observable.Notify(1);
+
+            for (std::size_t i = 0; i < CHURN; ++i) {
+                auto& id = ids[random() % ids.size()];
+                observable.Unsubscribe(id);
+                id = observable.Subscribe(DELEGATE_ARG<&OnEvent>);
+            }
+        });
+    }
+
+    {
+        Event observable{};
+        std::vector<Subscription> subscriptions{};
+        std::mt19937 random{1}; // NOLINT(cert-msc51-cpp)
+
+        for (std::size_t i = 0; i < SUBSCRIBERS; ++i) {
+            subscriptions.push_back(observable.Subscribe<&OnEvent>());
+        }
+
+        benchmark::Measure("Observable, frame (5000 subs, 100 churn)", frames, [&](const std::size_t) {
+            observable.Notify(1);
+
+            for (std::size_t i = 0; i < CHURN; ++i) {
+                subscriptions[random() % subscriptions.size()] = observable.Subscribe<&OnEvent>();
+            }
+        });
+
+        benchmark::Measure("Observable, churn during Notify", frames, [&](const std::size_t) {
+            // Observers unsubscribed and subscribed while the observable notifies.
+            auto churn = observable.Subscribe([&](const int) {
+                for (std::size_t i = 0; i < CHURN; ++i) {
+                    subscriptions[random() % subscriptions.size()] = observable.Subscribe<&OnEvent>();
+                }
+            });
+
+            observable.Notify(1);
+        });
+    }
+
+    benchmark::DoNotOptimize(counter);
+    return 0;
+}
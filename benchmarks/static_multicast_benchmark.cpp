@@ -0,0 +1,87 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "benchmark.h"
+#include <core/observer.h>
+#include <cstdint>
+#include <vector>
+
+using namespace core;
+
+namespace
+{
+    std::uint64_t total{};
+
+    void OnFirst(const int value)
+    {
+        total += static_cast<std::uint64_t>(value);
+    }
+
+    void OnSecond(const int value)
+    {
+        total ^= static_cast<std::uint64_t>(value) << 1;
+    }
+
+    void OnThird(const int value)
+    {
+        total += static_cast<std::uint64_t>(value) * 3;
+    }
+
+    void OnFourth(const int)
+    {
+        ++total;
+    }
+
+    class Event : public Observable<int>
+    {
+    public:
+        using Observable::Notify;
+    };
+
+    using StaticEvent = StaticMulticast<&OnFirst, &OnSecond, &OnThird, &OnFourth>;
+}
+
+int main()
+{
+    constexpr std::size_t iterations = 20'000'000;
+
+    benchmark::Measure("direct calls (4 handlers)", iterations, [](const std::size_t i) {
+        const auto value = static_cast<int>(i & 0xFF);
+        OnFirst(value);
+        OnSecond(value);
+        OnThird(value);
+        OnFourth(value);
+    });
+
+    benchmark::Measure("StaticMulticast::Notify (4 handlers)", iterations, [](const std::size_t i) {
+        StaticEvent::Notify(static_cast<int>(i & 0xFF));
+    });
+
+    Event event{};
+    std::vector<Subscription> subscriptions{};
+    subscriptions.push_back(event.Subscribe<&OnFirst>());
+    subscriptions.push_back(event.Subscribe<&OnSecond>());
+    subscriptions.push_back(event.Subscribe<&OnThird>());
+    subscriptions.push_back(event.Subscribe<&OnFourth>());
+
+    benchmark::Measure("Observable::Notify (4 handlers)", iterations, [&event](const std::size_t i) {
+        event.Notify(static_cast<int>(i & 0xFF));
+    });
+
+    benchmark::DoNotOptimize(total);
+    return 0;
+}
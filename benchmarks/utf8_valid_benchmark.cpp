@@ -0,0 +1,83 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "benchmark.h"
+#include "../tests/utf8_valid_reference.h"
+#include <core/strings/examination.h>
+#include <cstdio>
+#include <string>
+
+using namespace core;
+
+namespace
+{
+    /**
+     * @brief Repeats the sample up to about 64 KiB.
+    */
+    std::string Repeat(const std::string& sample)
+    {
+        std::string text{};
+
+        while (text.size() < 64 * 1024) {
+            text += sample;
+        }
+
+        return text;
+    }
+
+    const std::string LATIN = Repeat("gg wp, rush B! who has the bomb? ");
+    const std::string CYRILLIC = Repeat("\xD0\xBF\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82, \xD0\xBA\xD1\x82\xD0\xBE "
+                                        "\xD0\xB8\xD0\xB4\xD1\x91\xD1\x82 \xD0\xBD\xD0\xB0 B? ");
+    const std::string MIXED = Repeat("rush B \xD0\xB1\xD1\x8B\xD1\x81\xD1\x82\xD1\x80\xD0\xB5\xD0\xB5 \xF0\x9F\x98\x80 ");
+
+    /**
+     * @brief Measures the validator on the text and prints the throughput.
+    */
+    template <typename Validator>
+    void Run(const char* const name, const std::string& text, Validator validator)
+    {
+        // Read and write through volatile pointers, so the inlined validator is neither hoisted nor dropped.
+        const char* volatile string = text.c_str();
+        const char* volatile result{};
+
+        const auto ns = benchmark::Measure(name, 2'000, [&](const std::size_t) {
+            result = validator(string, text.size());
+        });
+
+        std::printf("%-48s %10.0f MB/s\n", "  throughput", static_cast<double>(text.size()) / ns * 1000.0);
+    }
+}
+
+int main()
+{
+    const auto reference = [](const char* const string, const std::size_t count) {
+        return test::Utf8ValidReference(string, count);
+    };
+
+    const auto vector = [](const char* const string, const std::size_t count) {
+        return str::Utf8Valid(string, count);
+    };
+
+    Run("scalar, Latin chat", LATIN, reference);
+    Run("str::Utf8Valid, Latin chat", LATIN, vector);
+    Run("scalar, Cyrillic chat", CYRILLIC, reference);
+    Run("str::Utf8Valid, Cyrillic chat", CYRILLIC, vector);
+    Run("scalar, mixed Cyrillic/Latin/emoji chat", MIXED, reference);
+    Run("str::Utf8Valid, mixed Cyrillic/Latin/emoji chat", MIXED, vector);
+
+    return 0;
+}
@@ -0,0 +1,312 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <core/delegate.h>
+#include <core/inplace_function.h>
+#include <core/mpsc_queue.h>
+#include <core/observer.h>
+#include <core/rcu.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef HAS_MHOOKS_LIB
+#include <mhooks/metamod.h>
+#endif
+
+namespace core
+{
+    /**
+     * @brief Observable that can be used from any thread.
+     *
+     * The observers live in an immutable snapshot that is replaced atomically on every change, so
+     * notifications never take a lock. Events posted by worker threads are handed to the game thread
+     * through a bounded lock-free queue and delivered by \c Dispatch at the start of every frame.
+    */
+    template <typename... Args>
+    class ConcurrentObservable : public detail::SubscriptionSource<ConcurrentObservable<Args...>>
+    {
+        using ObserverDelegate = Delegate<void(Args...)>;
+        using ObserverFunction = InplaceFunction<void(Args...)>;
+        using Event = std::tuple<std::decay_t<Args>...>;
+
+        struct Observer
+        {
+            SubscriptionId id;
+            ObserverFunction function;
+        };
+
+        using Observers = std::vector<Observer>;
+
+        RcuCell<Observers> observers_{std::make_unique<const Observers>()};
+        std::mutex write_mutex_{};
+        SubscriptionId next_id_{1};
+        MpscQueue<Event> events_;
+        std::atomic<std::size_t> dropped_count_{};
+
+#ifdef HAS_MHOOKS_LIB
+        std::unique_ptr<mhooks::MHook> start_frame_hook_{};
+#endif
+
+    public:
+        /**
+         * @brief Default capacity of the queue of posted events.
+        */
+        static constexpr std::size_t DEFAULT_QUEUE_CAPACITY = 1024;
+
+        /**
+         * @brief Constructor.
+         *
+         * @param queue_capacity The maximum number of posted events waiting for the game thread.
+         *
+         * @note Without mhooks, \c Dispatch must be called once per frame to deliver the posted events.
+        */
+        explicit ConcurrentObservable(const std::size_t queue_capacity = DEFAULT_QUEUE_CAPACITY)
+            : events_(queue_capacity)
+        {
+#ifdef HAS_MHOOKS_LIB
+            using namespace mhooks;
+            start_frame_hook_ = MHookGameDllStartFrame({DELEGATE_ARG<&ConcurrentObservable::OnStartFrame>, this},
+                                                       false, HookChainPriority::Uninterruptable)
+                                    ->Unique();
+#endif
+        }
+
+        /**
+         * @brief Destructor.
+        */
+        virtual ~ConcurrentObservable() = default;
+
+        /**
+         * @brief Copy constructor.
+        */
+        ConcurrentObservable(const ConcurrentObservable&) = delete;
+
+        /**
+         * @brief Move constructor.
+        */
+        ConcurrentObservable(ConcurrentObservable&&) = delete;
+
+        /**
+         * @brief Copy assignment operator.
+        */
+        ConcurrentObservable& operator=(const ConcurrentObservable&) = delete;
+
+        /**
+         * @brief Move assignment operator.
+        */
+        ConcurrentObservable& operator=(ConcurrentObservable&&) = delete;
+
+        /**
+         * @brief N/D
+         *
+         * @param observer A \c Delegate, or any callable that fits in an \c InplaceFunction.
+         *
+         * @note Can be called from any thread. Observers are called on the thread that notifies
+         * (the game thread for posted events); a notification in progress does not call the new observer.
+         *
+         * @return The subscription token; it unsubscribes when destroyed, on any thread.
+        */
+        [[nodiscard]] Subscription Subscribe(ObserverFunction&& observer)
+        {
+            const std::lock_guard lock{write_mutex_};
+
+            auto observers = std::make_unique<Observers>(*observers_.Current());
+            const auto handle = this->Handle();
+            const auto id = next_id_++;
+
+            observers->push_back({id, std::move(observer)});
+            observers_.Publish(std::move(observers));
+
+            return {handle, id};
+        }
+
+        /**
+         * @brief N/D
+         *
+         * @tparam Candidate Function or member to connect to the delegate.
+         *
+         * @return The subscription token; it unsubscribes when destroyed, on any thread.
+        */
+        template <auto Candidate>
+        [[nodiscard]] Subscription Subscribe()
+        {
+            return Subscribe({DELEGATE_ARG<Candidate>});
+        }
+
+        /**
+         * @brief N/D
+         *
+         * @tparam Candidate Function or member to connect to the delegate.
+         * @tparam Type Type of class or type of payload.
+         *
+         * @param value_or_instance A valid object that fits the purpose.
+         *
+         * @return The subscription token; it unsubscribes when destroyed, on any thread.
+        */
+        template <auto Candidate, typename Type>
+        [[nodiscard]] Subscription Subscribe(const Type* const value_or_instance)
+        {
+            return Subscribe({DELEGATE_ARG<Candidate>, value_or_instance});
+        }
+
+        /**
+         * @brief N/D
+         *
+         * @note Can be called from any thread. A notification in progress on another thread
+         * may still call the observer.
+         *
+         * @param id The unique identifier. Unknown identifiers are ignored.
+        */
+        void Unsubscribe(const SubscriptionId id)
+        {
+            const std::lock_guard lock{write_mutex_};
+
+            const auto* const current = observers_.Current();
+            const auto it = Find(*current, id);
+
+            if (it == current->end()) {
+                return;
+            }
+
+            auto observers = std::make_unique<Observers>();
+            observers->reserve(current->size() - 1);
+            observers->insert(observers->end(), current->begin(), it);
+            observers->insert(observers->end(), std::next(it), current->end());
+
+            observers_.Publish(std::move(observers));
+        }
+
+        /**
+         * @brief Returns \c true if the identifier refers to an active subscription.
+        */
+        [[nodiscard]] bool IsSubscribed(const SubscriptionId id) const noexcept
+        {
+            const auto scope = observers_.Pin();
+            const auto& observers = *observers_.Load();
+
+            return Find(observers, id) != observers.end();
+        }
+
+        /**
+         * @brief Returns the number of subscribed observers.
+        */
+        [[nodiscard]] std::size_t Size() const noexcept
+        {
+            const auto scope = observers_.Pin();
+            return observers_.Load()->size();
+        }
+
+        /**
+         * @brief Returns the number of posted events that were dropped because the queue was full.
+        */
+        [[nodiscard]] std::size_t DroppedCount() const noexcept
+        {
+            return dropped_count_.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Delivers the posted events to the observers on the calling thread and frees
+         * the replaced observer snapshots that are no longer read. Returns the number of delivered events.
+         *
+         * @note Called at the start of every frame with mhooks. Must be called from one thread only (the game thread).
+        */
+        std::size_t Dispatch()
+        {
+            // Events posted while dispatching wait for the next frame if the queue keeps refilling.
+            std::size_t count = 0;
+
+            for (const auto capacity = events_.Capacity(); count < capacity; ++count) {
+                const auto popped = events_.TryPop([this](Event&& event) {
+                    std::apply(
+                        [this](auto&... args) {
+                            Notify(std::forward<Args>(args)...);
+                        },
+                        event);
+                });
+
+                if (!popped) {
+                    break;
+                }
+            }
+
+            if (const std::unique_lock lock{write_mutex_, std::try_to_lock}; lock) {
+                observers_.Reclaim();
+            }
+
+            return count;
+        }
+
+    protected:
+        /**
+         * @brief Notify observers on the calling thread. Can be called from any thread without locking.
+         *
+         * @param args The callback arguments.
+         *
+         * @note Observers notified from worker threads must be thread-safe.
+        */
+        void Notify(Args... args) const
+        {
+            const auto scope = observers_.Pin();
+
+            for (const auto& observer : *observers_.Load()) {
+                observer.function(args...);
+            }
+        }
+
+        /**
+         * @brief Posts an event that is delivered to the observers on the game thread by \c Dispatch.
+         * Can be called from any thread without locking.
+         *
+         * @param args The callback arguments (stored by value until the event is delivered).
+         *
+         * @return \c false if the queue is full; the event is dropped in this case.
+        */
+        bool Post(Args... args)
+        {
+            if (events_.TryPush(std::forward<Args>(args)...)) {
+                return true;
+            }
+
+            dropped_count_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+    private:
+        [[nodiscard]] static auto Find(const Observers& observers, const SubscriptionId id) noexcept
+        {
+            return std::find_if(observers.begin(), observers.end(), [id](const Observer& observer) {
+                return observer.id == id;
+            });
+        }
+
+#ifdef HAS_MHOOKS_LIB
+        void OnStartFrame(const GameDllStartFrameMChain& chain)
+        {
+            Dispatch();
+            chain.CallNext();
+        }
+#endif
+    };
+}
@@ -23,9 +23,12 @@
 #include <metamod/config.h>
 #endif
 
+#include <core/strings/cstring_view.h>
+#include <core/strings/fixed_string.h>
 #include <core/strings/format.h>
 #include <cssdk/engine/eiface.h>
 #include <cssdk/public/os_defs.h>
+#include <cstddef>
 #include <cstdio>
 #include <string>
 #include <utility>
@@ -44,27 +47,65 @@ namespace core::console
     constexpr auto LOG_TAG = metamod::PLUGIN_LOG_TAG;
 #endif
 
+    /**
+     * @brief Maximum length of a console message formatted without a heap allocation.
+    */
+    constexpr std::size_t MESSAGE_INLINE_LENGTH = 1023;
+
+    /**
+     * @brief Stack buffer for a formatted console message.
+    */
+    using MessageString = str::FixedString<MESSAGE_INLINE_LENGTH>;
+
+    namespace detail
+    {
+        /**
+         * @brief Formats a console message into the stack buffer, or into \c overflow if it does not fit,
+         * and returns the null-terminated result. Long messages are never truncated.
+        */
+        template <typename... Args>
+        const char* FormatMessage(MessageString& buffer, std::string& overflow, const str::CStringView format, Args&&... args)
+        {
+            const auto required = str::FormatTo(buffer.data(), MessageString::capacity() + 1, format.c_str(), args...);
+
+            if (required < 0) {
+                buffer.clear();
+                return buffer.c_str();
+            }
+
+            if (static_cast<std::size_t>(required) <= MessageString::capacity()) {
+                buffer.commit(static_cast<std::size_t>(required));
+                return buffer.c_str();
+            }
+
+            overflow = str::Format(format.c_str(), std::forward<Args>(args)...);
+            return overflow.c_str();
+        }
+    }
+
     /**
      * @brief Prints a message to the server console.
     */
     template <bool LogTag = true, bool LineFeed = true, typename... Args>
-    ATTR_MINSIZE void Message(const std::string& format, Args&&... args)
+    ATTR_MINSIZE void Message(const str::CStringView format, Args&&... args)
     {
-        const auto& message = str::Format(format, std::forward<Args>(args)...);
+        MessageString buffer;
+        std::string overflow;
+        const auto* const message = detail::FormatMessage(buffer, overflow, format, std::forward<Args>(args)...);
 
         if constexpr (LogTag) {
             if constexpr (LineFeed) {
-                std::printf("[%s] %s\n", LOG_TAG, message.c_str());
+                std::printf("[%s] %s\n", LOG_TAG, message);
             }
             else {
-                std::printf("[%s] %s", LOG_TAG, message.c_str());
+                std::printf("[%s] %s", LOG_TAG, message);
             }
         }
         else if constexpr (LineFeed) {
-            std::printf("%s\n", message.c_str());
+            std::printf("%s\n", message);
         }
         else {
-            std::printf("%s", message.c_str());
+            std::printf("%s", message);
         }
     }
 
@@ -72,23 +113,25 @@ namespace core::console
      * @brief Prints a warning message with a log-tag to the server console.
     */
     template <bool LogTag = true, bool LineFeed = true, typename... Args>
-    ATTR_MINSIZE void Warning(const std::string& format, Args&&... args)
+    ATTR_MINSIZE void Warning(const str::CStringView format, Args&&... args)
     {
-        const auto& message = str::Format(format, std::forward<Args>(args)...);
+        MessageString buffer;
+        std::string overflow;
+        const auto* const message = detail::FormatMessage(buffer, overflow, format, std::forward<Args>(args)...);
 
         if (LogTag) {
             if constexpr (LineFeed) {
-                std::printf("[%s] WARNING! %s\n", LOG_TAG, message.c_str());
+                std::printf("[%s] WARNING! %s\n", LOG_TAG, message);
             }
             else {
-                std::printf("[%s] WARNING! %s", LOG_TAG, message.c_str());
+                std::printf("[%s] WARNING! %s", LOG_TAG, message);
             }
         }
         else if constexpr (LineFeed) {
-            std::printf("WARNING! %s\n", message.c_str());
+            std::printf("WARNING! %s\n", message);
         }
         else {
-            std::printf("WARNING! %s", message.c_str());
+            std::printf("WARNING! %s", message);
         }
     }
 
@@ -96,23 +139,25 @@ namespace core::console
      * @brief Prints an error message with a log-tag to the server console.
     */
     template <bool LogTag = true, bool LineFeed = true, typename... Args>
-    ATTR_MINSIZE void Error(const std::string& format, Args&&... args)
+    ATTR_MINSIZE void Error(const str::CStringView format, Args&&... args)
     {
-        const auto& message = str::Format(format, std::forward<Args>(args)...);
+        MessageString buffer;
+        std::string overflow;
+        const auto* const message = detail::FormatMessage(buffer, overflow, format, std::forward<Args>(args)...);
 
         if (LogTag) {
             if constexpr (LineFeed) {
-                std::printf("[%s] ERROR! %s\n", LOG_TAG, message.c_str());
+                std::printf("[%s] ERROR! %s\n", LOG_TAG, message);
             }
             else {
-                std::printf("[%s] ERROR! %s", LOG_TAG, message.c_str());
+                std::printf("[%s] ERROR! %s", LOG_TAG, message);
             }
         }
         else if constexpr (LineFeed) {
-            std::printf("ERROR! %s\n", message.c_str());
+            std::printf("ERROR! %s\n", message);
         }
         else {
-            std::printf("ERROR! %s", message.c_str());
+            std::printf("ERROR! %s", message);
         }
     }
 
@@ -123,16 +168,18 @@ namespace core::console
      * @note The value of the 'log' cvar should be 'on'.
     */
     template <bool LineFeed = true, typename... Args>
-    ATTR_MINSIZE void AlertMessage(const std::string& format, Args&&... args)
+    ATTR_MINSIZE void AlertMessage(const str::CStringView format, Args&&... args)
     {
         if (cssdk::g_engine_funcs.alert_message) {
+            MessageString buffer;
+            std::string overflow;
+            const auto* const message = detail::FormatMessage(buffer, overflow, format, std::forward<Args>(args)...);
+
             if constexpr (LineFeed) {
-                const auto& message = str::Format(format + "\n", std::forward<Args>(args)...);
-                cssdk::g_engine_funcs.alert_message(cssdk::AlertType::Logged, message.c_str());
+                cssdk::g_engine_funcs.alert_message(cssdk::AlertType::Logged, "%s\n", message);
             }
             else {
-                const auto& message = str::Format(format, std::forward<Args>(args)...);
-                cssdk::g_engine_funcs.alert_message(cssdk::AlertType::Logged, message.c_str());
+                cssdk::g_engine_funcs.alert_message(cssdk::AlertType::Logged, "%s", message);
             }
         }
     }
@@ -144,7 +191,7 @@ namespace core::console
      * @note The value of the 'developer' cvar should be '1' or '2'.
     */
     template <bool LineFeed = true, typename... Args>
-    ATTR_MINSIZE void AlertMessageDeveloper(const std::string& format, Args&&... args)
+    ATTR_MINSIZE void AlertMessageDeveloper(const str::CStringView format, Args&&... args)
     {
         if (cssdk::g_engine_funcs.cvar_get_float &&
             static_cast<bool>(cssdk::g_engine_funcs.cvar_get_float("developer"))) {
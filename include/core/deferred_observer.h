@@ -0,0 +1,276 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <core/delegate.h>
+#include <core/observer.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef HAS_MHOOKS_LIB
+#include <mhooks/metamod.h>
+#endif
+
+namespace core
+{
+    /**
+     * @brief Counters of a \c DeferredObservable.
+    */
+    struct DeferredEventStats
+    {
+        /**
+         * @brief Number of posted events, including the collapsed ones.
+        */
+        std::size_t posted{};
+
+        /**
+         * @brief Number of posted events merged into an event queued with the same key.
+        */
+        std::size_t collapsed{};
+
+        /**
+         * @brief Number of events delivered to the observers.
+        */
+        std::size_t dispatched{};
+    };
+
+    /**
+     * @brief Observable that queues the posted events and delivers them in one batch at the start of the next frame.
+     *
+     * Events posted with the same key in a frame are coalesced: the queued event keeps its position
+     * and takes the arguments of the last post, so the observers run once per key and frame.
+    */
+    template <typename... Args>
+    class DeferredObservable : public Observable<Args...>
+    {
+        using Event = std::tuple<std::decay_t<Args>...>;
+
+        // Ring buffer indexed by the sequence number of the event. The capacity is a power of two and
+        // grows when the queue is full; the storage is reused from frame to frame.
+        std::vector<std::optional<Event>> ring_{};
+        std::uint64_t push_sequence_{};
+        std::uint64_t pop_sequence_{};
+
+        // Sequence numbers of the events queued with a key in the current frame.
+        std::unordered_map<std::uint64_t, std::uint64_t> keyed_events_{};
+        DeferredEventStats stats_{};
+
+#ifdef HAS_MHOOKS_LIB
+        std::unique_ptr<mhooks::MHook> start_frame_hook_{};
+#endif
+
+    public:
+        /**
+         * @brief Constructor.
+         *
+         * @param capacity The initial capacity of the queue (rounded up to a power of two).
+         *
+         * @note Without mhooks, \c Dispatch must be called once per frame to deliver the queued events.
+        */
+        explicit DeferredObservable(const std::size_t capacity = 64)
+            : ring_(RoundCapacity(capacity))
+        {
+        }
+
+        /**
+         * @brief Destructor.
+        */
+        ~DeferredObservable() override = default;
+
+        /**
+         * @brief Copy constructor.
+        */
+        DeferredObservable(const DeferredObservable&) = delete;
+
+        /**
+         * @brief Move constructor.
+        */
+        DeferredObservable(DeferredObservable&&) = delete;
+
+        /**
+         * @brief Copy assignment operator.
+        */
+        DeferredObservable& operator=(const DeferredObservable&) = delete;
+
+        /**
+         * @brief Move assignment operator.
+        */
+        DeferredObservable& operator=(DeferredObservable&&) = delete;
+
+        /**
+         * @brief Returns the number of queued events.
+        */
+        [[nodiscard]] std::size_t Pending() const noexcept
+        {
+            return static_cast<std::size_t>(push_sequence_ - pop_sequence_);
+        }
+
+        /**
+         * @brief Returns the event counters accumulated since the construction or the last \c ResetStats.
+        */
+        [[nodiscard]] const DeferredEventStats& Stats() const noexcept
+        {
+            return stats_;
+        }
+
+        /**
+         * @brief Resets the event counters.
+        */
+        void ResetStats() noexcept
+        {
+            stats_ = {};
+        }
+
+        /**
+         * @brief Delivers the queued events to the observers in the order they were posted.
+         * Returns the number of delivered events.
+         *
+         * @note Called at the start of every frame with mhooks. Events posted by the observers are delivered
+         * by the next dispatch.
+        */
+        std::size_t Dispatch()
+        {
+            keyed_events_.clear();
+
+            const auto end = push_sequence_;
+            std::size_t count = 0;
+
+            while (pop_sequence_ != end) {
+                // Move the event out, the ring may grow while the observers are called.
+                auto& slot = ring_[static_cast<std::size_t>(pop_sequence_++) & (ring_.size() - 1)];
+                auto event = std::move(*slot);
+                slot.reset();
+
+                std::apply(
+                    [this](auto&... args) {
+                        this->Notify(std::forward<Args>(args)...);
+                    },
+                    event);
+
+                ++count;
+            }
+
+            stats_.dispatched += count;
+
+#ifdef HAS_MHOOKS_LIB
+            if (pop_sequence_ == push_sequence_ && start_frame_hook_) {
+                start_frame_hook_->Disable();
+            }
+#endif
+            return count;
+        }
+
+    protected:
+        /**
+         * @brief Queues an event that is delivered at the start of the next frame.
+         *
+         * @param args The callback arguments (stored by value until the event is delivered).
+        */
+        void Post(Args... args)
+        {
+            Push(std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Queues an event that is delivered at the start of the next frame. If an event with the same key
+         * is already queued in this frame, its arguments are replaced instead and the post is counted as collapsed.
+         *
+         * @param key User defined key of the event (e.g. the entity index, or a hash of the cvar name).
+         * @param args The callback arguments (stored by value until the event is delivered).
+        */
+        void PostKeyed(const std::uint64_t key, Args... args)
+        {
+            if (const auto it = keyed_events_.find(key); it != keyed_events_.end() && it->second >= pop_sequence_) {
+                ring_[static_cast<std::size_t>(it->second) & (ring_.size() - 1)].emplace(std::forward<Args>(args)...);
+                ++stats_.posted;
+                ++stats_.collapsed;
+
+                return;
+            }
+
+            keyed_events_.insert_or_assign(key, push_sequence_);
+            Push(std::forward<Args>(args)...);
+        }
+
+    private:
+        template <typename... EventArgs>
+        void Push(EventArgs&&... args)
+        {
+            if (Pending() == ring_.size()) {
+                Grow();
+            }
+
+            ring_[static_cast<std::size_t>(push_sequence_++) & (ring_.size() - 1)].emplace(std::forward<EventArgs>(args)...);
+            ++stats_.posted;
+
+#ifdef HAS_MHOOKS_LIB
+            // The hook is disabled while the queue is empty.
+            if (Pending() != 1) {
+                return;
+            }
+
+            if (start_frame_hook_) {
+                start_frame_hook_->Enable();
+            }
+            else {
+                using namespace mhooks;
+                start_frame_hook_ = MHookGameDllStartFrame({DELEGATE_ARG<&DeferredObservable::OnStartFrame>, this},
+                                                           false, HookChainPriority::Uninterruptable)
+                                        ->Unique();
+            }
+#endif
+        }
+
+        void Grow()
+        {
+            std::vector<std::optional<Event>> ring(ring_.size() * 2);
+
+            for (auto sequence = pop_sequence_; sequence != push_sequence_; ++sequence) {
+                ring[static_cast<std::size_t>(sequence) & (ring.size() - 1)] =
+                    std::move(ring_[static_cast<std::size_t>(sequence) & (ring_.size() - 1)]);
+            }
+
+            ring_.swap(ring);
+        }
+
+        [[nodiscard]] static std::size_t RoundCapacity(const std::size_t capacity) noexcept
+        {
+            std::size_t result = 2;
+
+            while (result < capacity) {
+                result <<= 1;
+            }
+
+            return result;
+        }
+
+#ifdef HAS_MHOOKS_LIB
+        void OnStartFrame(const GameDllStartFrameMChain& chain)
+        {
+            Dispatch();
+            chain.CallNext();
+        }
+#endif
+    };
+}
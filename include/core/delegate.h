@@ -371,6 +371,14 @@ namespace core
             return data_;
         }
 
+        /**
+         * @brief Returns the function called with the instance or the payload as the first argument, if any.
+        */
+        [[nodiscard]] FunctionType* Function() const noexcept
+        {
+            return fn_;
+        }
+
         /**
          * @brief Triggers a delegate.
          *
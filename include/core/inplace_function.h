@@ -0,0 +1,343 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <core/delegate.h>
+#include <cssdk/public/os_defs.h>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// ReSharper disable CppNonExplicitConvertingConstructor
+
+namespace core
+{
+    /**
+     * @brief Default capacity of the \c InplaceFunction buffer (in bytes).
+    */
+    inline constexpr std::size_t INPLACE_FUNCTION_CAPACITY = 4 * sizeof(void*);
+
+    /**
+     * @brief Basic inplace function declaration.
+     *
+     * Primary template isn't defined on purpose. All the specializations give a compile-time error
+     * unless the template parameter is a function type.
+    */
+    template <typename, std::size_t Capacity = INPLACE_FUNCTION_CAPACITY>
+    class InplaceFunction;
+
+    namespace detail
+    {
+        template <typename>
+        struct IsDelegate : std::false_type
+        {
+        };
+
+        template <typename Signature>
+        struct IsDelegate<Delegate<Signature>> : std::true_type
+        {
+        };
+    }
+
+    /**
+     * @brief Owning callable wrapper with a fixed inline buffer.
+     *
+     * Unlike \c Delegate, it stores a copy of the callable (e.g. a capturing lambda), so the callable
+     * does not have to outlive it. Unlike \c std::function, it never allocates: a callable that does not fit
+     * in the buffer is a compile-time error. It is also constructible from everything \c Delegate is;
+     * a \c Delegate of the same signature is unwrapped, so calling it costs one indirect call, as the delegate does.
+     *
+     * @tparam Ret Return type of a function type.
+     * @tparam Args Types of arguments of a function type.
+     * @tparam Capacity Size of the inline buffer in bytes.
+    */
+    template <typename Ret, typename... Args, std::size_t Capacity>
+    class InplaceFunction<Ret(Args...), Capacity>
+    {
+        enum class Operation
+        {
+            Copy,
+            Move,
+            Destroy
+        };
+
+        // Same as Delegate::FunctionType, so a delegate is stored as its function and payload.
+        using InvokeType = Ret(const void*, Args...);
+        using ManageType = void(Operation, void*, void*);
+
+        alignas(std::max_align_t) unsigned char storage_[Capacity];
+        InvokeType* invoke_{};
+        ManageType* manage_{};
+
+        // First argument of invoke_: the buffer of a stored callable, or the payload of a delegate.
+        const void* context_{};
+
+        template <typename Callable>
+        ATTR_OPTIMIZE_HOT static Ret Invoke(const void* const storage, Args... args)
+        {
+            return static_cast<Ret>(
+                std::invoke(*static_cast<Callable*>(const_cast<void*>(storage)), std::forward<Args>(args)...));
+        }
+
+        template <typename Callable>
+        static void Manage(const Operation operation, void* const destination, void* const source)
+        {
+            switch (operation) {
+            case Operation::Copy:
+                ::new (destination) Callable(*static_cast<const Callable*>(source));
+                break;
+
+            case Operation::Move:
+                ::new (destination) Callable(std::move(*static_cast<Callable*>(source)));
+                static_cast<Callable*>(source)->~Callable();
+                break;
+
+            case Operation::Destroy:
+                static_cast<Callable*>(destination)->~Callable();
+                break;
+            }
+        }
+
+    public:
+        /**
+         * @brief Function type of the inplace function.
+        */
+        using Type = Ret(Args...);
+
+        /**
+         * @brief Return type of the inplace function.
+        */
+        using ResultType = Ret;
+
+        /**
+         * @brief Default constructor.
+        */
+        InplaceFunction() noexcept = default;
+
+        /**
+         * @brief Constructs an empty inplace function.
+        */
+        InplaceFunction(std::nullptr_t) noexcept // cppcheck-suppress noExplicitConstructor
+        {
+        }
+
+        /**
+         * @brief Constructs an inplace function from a callable object (lambda, functor, function pointer,
+         * member pointer or \c Delegate). Null pointers and empty delegates result in an empty function.
+         *
+         * @param function The callable object to copy or move into the buffer.
+        */
+        template <typename Function,
+                  typename = std::enable_if_t<!std::is_same_v<std::decay_t<Function>, InplaceFunction> &&
+                                              std::is_invocable_r_v<Ret, std::decay_t<Function>&, Args...>>>
+        InplaceFunction(Function&& function) // cppcheck-suppress noExplicitConstructor
+        {
+            using Callable = std::decay_t<Function>;
+
+            static_assert(sizeof(Callable) <= Capacity, "The callable is too large for the InplaceFunction capacity.");
+            static_assert(alignof(Callable) <= alignof(std::max_align_t), "The callable is over-aligned.");
+            static_assert(std::is_copy_constructible_v<Callable>, "The callable must be copy constructible.");
+            static_assert(std::is_nothrow_move_constructible_v<Callable>,
+                          "The callable must be nothrow move constructible (InplaceFunction moves are noexcept).");
+
+            if constexpr (std::is_pointer_v<Callable> || std::is_member_pointer_v<Callable> ||
+                          detail::IsDelegate<Callable>::value) {
+                if (!function) {
+                    return;
+                }
+            }
+
+            if constexpr (std::is_same_v<Callable, Delegate<Ret(Args...)>>) {
+                // Call the function of the delegate directly rather than through the delegate.
+                invoke_ = function.Function();
+                context_ = function.Instance();
+            }
+            else {
+                ::new (static_cast<void*>(storage_)) Callable(std::forward<Function>(function));
+                invoke_ = &Invoke<Callable>;
+                context_ = storage_;
+
+                if constexpr (!std::is_trivially_copyable_v<Callable> || !std::is_trivially_destructible_v<Callable>) {
+                    manage_ = &Manage<Callable>;
+                }
+            }
+        }
+
+        /**
+         * @brief Constructs an inplace function and connects a free function or an unbound member.
+         *
+         * @tparam Candidate Function or member to connect to the delegate.
+        */
+        template <auto Candidate>
+        InplaceFunction(DelegateArgType<Candidate> arg) noexcept // cppcheck-suppress noExplicitConstructor
+            : InplaceFunction(Delegate<Ret(Args...)>{arg})
+        {
+        }
+
+        /**
+         * @brief Constructs an inplace function and connects a free function with payload or a bound member.
+         *
+         * @tparam Candidate Function or member to connect to the delegate.
+         * @tparam Type Type of class or type of payload.
+         *
+         * @param value_or_instance A valid object that fits the purpose.
+        */
+        template <auto Candidate, typename Type>
+        InplaceFunction(DelegateArgType<Candidate> arg, Type* const value_or_instance) noexcept
+            : InplaceFunction(Delegate<Ret(Args...)>{arg, value_or_instance})
+        {
+        }
+
+        /**
+         * @brief Destructor.
+        */
+        ~InplaceFunction()
+        {
+            Reset();
+        }
+
+        /**
+         * @brief Copy constructor.
+        */
+        InplaceFunction(const InplaceFunction& other)
+        {
+            CopyFrom(other);
+        }
+
+        /**
+         * @brief Move constructor.
+        */
+        InplaceFunction(InplaceFunction&& other) noexcept
+        {
+            MoveFrom(other);
+        }
+
+        /**
+         * @brief Copy assignment operator.
+        */
+        InplaceFunction& operator=(const InplaceFunction& other)
+        {
+            if (this != &other) {
+                Reset();
+                CopyFrom(other);
+            }
+
+            return *this;
+        }
+
+        /**
+         * @brief Move assignment operator.
+        */
+        InplaceFunction& operator=(InplaceFunction&& other) noexcept
+        {
+            if (this != &other) {
+                Reset();
+                MoveFrom(other);
+            }
+
+            return *this;
+        }
+
+        /**
+         * @brief Resets the inplace function.
+        */
+        InplaceFunction& operator=(std::nullptr_t) noexcept
+        {
+            Reset();
+            return *this;
+        }
+
+        /**
+         * @brief Resets the inplace function (destroys the stored callable).\n
+         * After a reset, the inplace function cannot be invoked anymore.
+        */
+        void Reset() noexcept
+        {
+            if (manage_) {
+                manage_(Operation::Destroy, storage_, nullptr);
+            }
+
+            invoke_ = nullptr;
+            manage_ = nullptr;
+            context_ = nullptr;
+        }
+
+        /**
+         * @brief Triggers the inplace function.
+         *
+         * Attempting to trigger an empty inplace function results in undefined behavior.
+         *
+         * @param args Arguments to use to invoke the underlying callable.
+         *
+         * @return The value returned by the underlying callable.
+        */
+        ATTR_OPTIMIZE_HOT FORCEINLINE Ret operator()(Args... args) const
+        {
+            assert(static_cast<bool>(*this) && "InplaceFunction is uninitialized.");
+
+            // Like std::function, a const call may invoke a non-const call operator of the stored callable.
+            return invoke_(context_, std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Checks whether the inplace function actually stores a callable.
+         *
+         * @return \c false if the inplace function is empty; \c true otherwise.
+        */
+        [[nodiscard]] explicit operator bool() const noexcept
+        {
+            return !(invoke_ == nullptr);
+        }
+
+    private:
+        void CopyFrom(const InplaceFunction& other)
+        {
+            if (other.manage_) {
+                other.manage_(Operation::Copy, storage_, const_cast<unsigned char*>(other.storage_));
+            }
+            else if (other.context_ == other.storage_) {
+                std::memcpy(storage_, other.storage_, Capacity);
+            }
+
+            invoke_ = other.invoke_;
+            manage_ = other.manage_;
+            context_ = other.context_ == other.storage_ ? storage_ : other.context_;
+        }
+
+        void MoveFrom(InplaceFunction& other) noexcept
+        {
+            if (other.manage_) {
+                other.manage_(Operation::Move, storage_, other.storage_);
+            }
+            else if (other.context_ == other.storage_) {
+                std::memcpy(storage_, other.storage_, Capacity);
+            }
+
+            invoke_ = other.invoke_;
+            manage_ = other.manage_;
+            context_ = other.context_ == other.storage_ ? storage_ : other.context_;
+            other.invoke_ = nullptr;
+            other.manage_ = nullptr;
+            other.context_ = nullptr;
+        }
+    };
+}
@@ -18,46 +18,429 @@
 #pragma once
 
 #ifdef HAS_METAMOD_LIB
+#include <core/rcu.h>
 #include <core/strings.h>
 #include <cssdk/engine/edict.h>
 #include <cssdk/public/os_defs.h>
+#include <array>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#ifdef HAS_MHOOKS_LIB
+#include <core/messages.h>
+#include <cssdk/common/const.h>
+#include <mhooks/metamod.h>
+#endif
+
+namespace core::detail
+{
+    /**
+     * @brief Returns the FNV-1a hash of the localization label.
+    */
+    [[nodiscard]] constexpr std::uint64_t HashLabel(const std::string_view label) noexcept
+    {
+        std::uint64_t hash = 14695981039346656037ULL;
+
+        for (const auto ch : label) {
+            hash ^= static_cast<unsigned char>(ch);
+            hash *= 1099511628211ULL;
+        }
+
+        return hash;
+    }
+
+    /**
+     * @brief Header of the compiled localization image (also the layout of the binary cache file).
+    */
+    struct LocalizationImageHeader
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t fingerprint;
+        std::uint32_t image_size;
+        std::uint32_t language_count;
+        std::uint32_t label_count;
+        std::uint32_t slot_count;
+        std::uint32_t languages_offset;
+        std::uint32_t labels_offset;
+        std::uint32_t slots_offset;
+        std::uint32_t texts_offset;
+        std::uint32_t arena_offset;
+        std::uint32_t arena_size;
+    };
+
+    /**
+     * @brief Language code entry of the compiled localization image.
+    */
+    struct LocalizationImageLanguage
+    {
+        char code[4];
+    };
+
+    /**
+     * @brief Label entry of the compiled localization image.
+    */
+    struct LocalizationImageLabel
+    {
+        std::uint64_t hash;
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    /**
+     * @brief Text entry of the compiled localization image.
+    */
+    struct LocalizationImageText
+    {
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    /**
+     * @brief Immutable, flat localization table.
+     *
+     * Labels are interned to dense IDs, texts are stored in a single contiguous arena
+     * and addressed by a \c [language][label_id] table. Label lookup uses an open addressing
+     * hash index that verifies the label text, so different labels never collide.
+    */
+    class LocalizationTable
+    {
+        std::shared_ptr<const void> image_{};
+        const LocalizationImageHeader* header_{};
+        const LocalizationImageLanguage* languages_{};
+        const LocalizationImageLabel* labels_{};
+        const std::uint32_t* slots_{};
+        const LocalizationImageText* texts_{};
+        const char* arena_{};
+        std::uint32_t default_language_{};
+
+    public:
+        /**
+         * @brief Invalid language index or label ID.
+        */
+        static constexpr std::uint32_t NPOS = UINT32_MAX;
+
+        /**
+         * @brief Constructor.
+         *
+         * @param image Validated compiled localization image.
+        */
+        explicit LocalizationTable(std::shared_ptr<const void> image);
+
+        /**
+         * @brief Returns the number of languages.
+        */
+        [[nodiscard]] std::uint32_t LanguageCount() const noexcept
+        {
+            return header_->language_count;
+        }
+
+        /**
+         * @brief Returns the number of labels.
+        */
+        [[nodiscard]] std::uint32_t LabelCount() const noexcept
+        {
+            return header_->label_count;
+        }
+
+        /**
+         * @brief Returns the index of the "en" language, or the first language if "en" is missing.
+        */
+        [[nodiscard]] std::uint32_t DefaultLanguage() const noexcept
+        {
+            return default_language_;
+        }
+
+        /**
+         * @brief Returns the index of the language, or \c NPOS if not found.
+        */
+        [[nodiscard]] std::uint32_t FindLanguage(std::string_view lang) const noexcept;
+
+        /**
+         * @brief Returns the ID of the label, or \c NPOS if not found.
+        */
+        [[nodiscard]] std::uint32_t FindLabel(std::string_view label, std::uint64_t hash) const noexcept;
+
+        /**
+         * @brief Returns the ID of the label, or \c NPOS if not found.
+        */
+        [[nodiscard]] std::uint32_t FindLabel(const std::string_view label) const noexcept
+        {
+            return FindLabel(label, HashLabel(label));
+        }
+
+        /**
+         * @brief Returns the text of the label in the language, or \c nullptr if there is no such text.
+        */
+        [[nodiscard]] const LocalizationImageText* FindText(const std::uint32_t language, const std::uint32_t label_id) const noexcept
+        {
+            if (language >= header_->language_count || label_id >= header_->label_count) {
+                return nullptr;
+            }
+
+            const auto* const text = texts_ + static_cast<std::size_t>(language) * header_->label_count + label_id;
+            return text->offset == NPOS ? nullptr : text;
+        }
+
+        /**
+         * @brief Returns a null-terminated text entry.
+        */
+        [[nodiscard]] str::CStringView GetText(const LocalizationImageText* const text) const noexcept
+        {
+            return {arena_ + text->offset, text->length};
+        }
+
+        /**
+         * @brief Returns the language code at the specified index.
+        */
+        [[nodiscard]] std::string_view GetLanguage(const std::uint32_t language) const noexcept
+        {
+            return languages_[language].code;
+        }
+    };
+
+    /**
+     * @brief Immutable state published by \c Localization: the table and the table IDs of the resolved labels.
+    */
+    struct LocalizationSnapshot
+    {
+        std::shared_ptr<const LocalizationTable> table{};
+        std::vector<std::uint32_t> resolved_ids{};
+    };
+
+#ifdef HAS_MHOOKS_LIB
+    /**
+     * @brief Connected players grouped by their language in the localization table.
+    */
+    struct LocalizationPlayerGroups
+    {
+        std::size_t group_count{};
+        std::array<str::CStringView, cssdk::MAX_CLIENTS> texts{};
+        std::array<std::size_t, cssdk::MAX_CLIENTS + 1> offsets{};
+        std::array<cssdk::Edict*, cssdk::MAX_CLIENTS> players{};
+    };
+#endif
+
+    /**
+     * @brief Result of a localization build: the compiled image (or \c nullptr) and the messages to report.
+    */
+    struct LocalizationBuild
+    {
+        std::shared_ptr<const void> image{};
+        std::vector<std::string> messages{};
+    };
+}
+
 namespace core
 {
+    /**
+     * @brief Localization label handle.
+     *
+     * Can be created from a string literal at compile time (the label hash is computed once by the compiler),
+     * or returned by \c Localization::Resolve, in which case a lookup is a plain array index.
+    */
+    class LocLabel
+    {
+        friend class Localization;
+
+        std::string_view label_{};
+        std::uint64_t hash_{};
+        std::uint32_t id_{detail::LocalizationTable::NPOS};
+
+        constexpr LocLabel(const std::string_view label, const std::uint64_t hash, const std::uint32_t id) noexcept
+            : label_(label), hash_(hash), id_(id)
+        {
+        }
+
+    public:
+        /**
+         * @brief Constructor.
+        */
+        constexpr LocLabel() noexcept = default;
+
+        /**
+         * @brief Constructor.
+         *
+         * @note The label string must outlive the handle (use string literals).
+        */
+        constexpr explicit LocLabel(const std::string_view label) noexcept
+            : label_(label), hash_(detail::HashLabel(label))
+        {
+        }
+
+        /**
+         * @brief Returns the label string.
+        */
+        [[nodiscard]] constexpr std::string_view Label() const noexcept
+        {
+            return label_;
+        }
+
+        /**
+         * @brief Returns the label hash.
+        */
+        [[nodiscard]] constexpr std::uint64_t Hash() const noexcept
+        {
+            return hash_;
+        }
+
+        /**
+         * @brief Returns \c true if the label was resolved by \c Localization::Resolve.
+        */
+        [[nodiscard]] constexpr bool IsResolved() const noexcept
+        {
+            return id_ != detail::LocalizationTable::NPOS;
+        }
+    };
+
     class Localization
     {
-        std::string filepath_;
+        std::vector<std::string> filepaths_;
+        bool binary_cache_{};
         std::string notfound_{"ML_NOTFOUND"};
-        std::vector<std::string> languages_{};
-        std::unordered_map<std::size_t, std::string> localization_{};
+
+        // The published snapshot is read without locking.
+        RcuCell<detail::LocalizationSnapshot> snapshot_{};
+        std::future<detail::LocalizationBuild> pending_build_{};
+
+#ifdef HAS_MHOOKS_LIB
+        std::unique_ptr<mhooks::MHook> start_frame_hook_{};
+#endif
+
+        // Labels resolved to handles (stable storage).
+        std::deque<std::string> resolved_labels_{};
+        std::unordered_map<std::string_view, std::uint32_t> resolved_label_ids_{};
 
     public:
         /**
          * @brief Constructor.
          *
          * @param filepath The path to the localization file.
+         * @param binary_cache If \c true, the compiled table is saved next to the localization file
+         * (\c filepath + \c ".cache") and memory mapped on the next load if the source file is unchanged.
+        */
+        explicit Localization(std::string filepath, bool binary_cache = false);
+
+        /**
+         * @brief Constructor.
+         *
+         * @param filepaths The paths to the localization files. The files are merged in order; if a label is
+         * defined in several files for the same language, the text from the last file is used.
+         * @param binary_cache If \c true, the compiled table is saved next to the first localization file
+         * (\c filepath + \c ".cache") and memory mapped on the next load if no source file is changed.
+        */
+        explicit Localization(std::vector<std::string> filepaths, bool binary_cache = false);
+
+        /**
+         * @brief Destructor. Waits for a pending background reload.
+        */
+        ~Localization();
+
+        /**
+         * @brief Copy constructor.
+        */
+        Localization(const Localization&) = delete;
+
+        /**
+         * @brief Move constructor.
+        */
+        Localization(Localization&&) = delete;
+
+        /**
+         * @brief Copy assignment operator.
+        */
+        Localization& operator=(const Localization&) = delete;
+
+        /**
+         * @brief Move assignment operator.
         */
-        explicit Localization(std::string filepath);
+        Localization& operator=(Localization&&) = delete;
 
         /**
-         * @brief Reloads the localization file.
+         * @brief Reloads the localization files.
         */
         void Reload();
 
+        /**
+         * @brief Reloads the localization files on a worker thread. The new table is published at the start
+         * of a frame once it is built; until then, the current table is used. Returns \c false if a
+         * background reload is already in progress.
+         *
+         * @note \c GetText can be called from any thread with an explicit language code. A returned text
+         * remains valid on the game thread until the end of the frame or the next \c Reload call;
+         * other threads should use \c Pin.
+         * @note Without mhooks, \c Update must be called once per frame to publish the table.
+        */
+        bool ReloadAsync();
+
+        /**
+         * @brief Publishes the table built by \c ReloadAsync if it is ready and frees the replaced tables
+         * that are no longer read. Returns \c true if a new table was published.
+        */
+        bool Update();
+
+        /**
+         * @brief Keeps the texts returned by \c GetText valid while the returned scope is alive, even if
+         * a new table is published meanwhile. Use it when reading texts on a thread other than the game thread.
+        */
+        [[nodiscard]] RcuReadScope Pin() const noexcept
+        {
+            return snapshot_.Pin();
+        }
+
+        /**
+         * @brief Returns the sorted paths of the files with the specified extension in the directory
+         * (e.g. \c FindFiles("data/lang") returns all \c .txt files in \c data/lang).
+        */
+        [[nodiscard]] static std::vector<std::string> FindFiles(const std::string& directory,
+                                                                std::string_view extension = ".txt");
+
         /**
          * @brief Gets the text by the text label.
          *
          * @note Set lang value to \c "server" to get the language from the amx_language CVar.
          * @note Set lang value to \c "player" to get the language from the player config (setinfo "lang").
+         * @note Returns a view into the current table (it used to be a \c const \c std::string&): copy the text
+         * to keep it. On the game thread, the view remains valid until the end of the frame or the next \c Reload
+         * call; on other threads, only while a \c Pin scope taken before the call is alive.
+        */
+        [[nodiscard]] str::CStringView GetText(const std::string& lang, std::string_view label,
+                                               cssdk::Edict* client = nullptr) const;
+
+        /**
+         * @brief Resolves the label to a handle that is looked up by an array index.
+         * Unknown labels are reported to the console once, here.
+         *
+         * @note Resolved handles remain valid after \c Reload and are bound to this \c Localization instance.
+        */
+        [[nodiscard]] LocLabel Resolve(std::string_view label);
+
+        /**
+         * @brief Resolves the label to a handle that is looked up by an array index.
+         * Unknown labels are reported to the console once, here.
+         *
+         * @note Resolved handles remain valid after \c Reload and are bound to this \c Localization instance.
         */
-        [[nodiscard]] const std::string& GetText(const std::string& lang, std::string_view label,
-                                                 cssdk::Edict* client = nullptr) const;
+        [[nodiscard]] LocLabel Resolve(LocLabel label);
+
+        /**
+         * @brief Gets the text by the label handle.
+         *
+         * @note Set lang value to \c "server" to get the language from the amx_language CVar.
+         * @note Set lang value to \c "player" to get the language from the player config (setinfo "lang").
+         * @note The returned view remains valid as long as the one returned by \c GetText with a text label.
+        */
+        [[nodiscard]] str::CStringView GetText(const std::string& lang, LocLabel label,
+                                               cssdk::Edict* client = nullptr) const;
+
         /**
          * @brief Gets the text by the text label.
          *
@@ -76,19 +459,142 @@ namespace core
         template <typename... Args>
         [[nodiscard]] std::string GetTextFormat(const std::string& lang, std::string_view label,
                                                 cssdk::Edict* client, Args&&... args) const;
+
+        /**
+         * @brief Gets the text by the label handle.
+         *
+         * @note Set lang value to \c "server" to get the language from the amx_language CVar.
+         * @note Set lang value to \c "player" to get the language from the player config (setinfo "lang").
+        */
+        template <typename... Args>
+        [[nodiscard]] std::string GetTextFormat(const std::string& lang, LocLabel label,
+                                                cssdk::Edict* client, Args&&... args) const;
+
+#ifdef HAS_MHOOKS_LIB
+        /**
+         * @brief Formats the text once per distinct language of the connected players and calls
+         * \c send(client, text) for each player of the language group. If all players share a language
+         * and \c AllClients is \c true, \c send is called once with \c nullptr client (all clients).
+        */
+        template <std::size_t Capacity = messages::TEXT_MAX_LENGTH, bool AllClients = true, typename Send, typename... Args>
+        void Broadcast(LocLabel label, Send&& send, const Args&... args) const;
+
+        /**
+         * @brief Sends a localized text message to all clients, formatted once per language.
+        */
+        template <typename... Args>
+        ATTR_MINSIZE void BroadcastTextMessage(const cssdk::HudPrint dest, const LocLabel label, const Args&... args) const
+        {
+            Broadcast(
+                label, [dest](cssdk::Edict* const client, const str::CStringView text) {
+                    messages::SendTextMessage(client, dest, text);
+                },
+                args...);
+        }
+
+        /**
+         * @brief Sends a localized chat message to all clients, formatted once per language.
+        */
+        template <typename... Args>
+        ATTR_MINSIZE void BroadcastChatMessage(const int sender, const LocLabel label, const Args&... args) const
+        {
+            Broadcast(
+                label, [sender](cssdk::Edict* const client, const str::CStringView text) {
+                    messages::SendChatMessage(client, sender, text);
+                },
+                args...);
+        }
+
+        /**
+         * @brief Sends a localized colored chat message to all clients, formatted once per language.
+        */
+        template <messages::SayTextTeamColor Color = messages::SayTextTeamColor::Default, typename... Args>
+        ATTR_MINSIZE void BroadcastChatColorMessage(const LocLabel label, const Args&... args) const
+        {
+            // The default color is the team color of the receiving player, so it is always sent per player.
+            Broadcast<messages::TEXT_MAX_LENGTH, Color != messages::SayTextTeamColor::Default>(
+                label, [](cssdk::Edict* const client, const str::CStringView text) {
+                    messages::SendChatColorMessage(client, text, Color);
+                },
+                args...);
+        }
+
+        /**
+         * @brief Sends a localized HUD message to all clients, formatted once per language.
+        */
+        template <typename... Args>
+        ATTR_MINSIZE void BroadcastHudMessage(const cssdk::HudTextParams& hud_params, const LocLabel label,
+                                              const Args&... args) const
+        {
+            Broadcast<messages::HUD_TEXT_MAX_LENGTH>(
+                label, [&hud_params](cssdk::Edict* const client, const str::CStringView text) {
+                    messages::SendHudMessage(client, hud_params, text);
+                },
+                args...);
+        }
+#endif
+
+    private:
+#ifdef HAS_MHOOKS_LIB
+        void GroupPlayers(LocLabel label, detail::LocalizationPlayerGroups& groups) const;
+#endif
+        [[nodiscard]] static std::uint32_t GetLabelId(const detail::LocalizationSnapshot* snapshot, LocLabel label) noexcept;
+        [[nodiscard]] str::CStringView GetText(const detail::LocalizationSnapshot* snapshot, const std::string& lang,
+                                               std::uint32_t label_id, cssdk::Edict* client) const;
+        void Publish(detail::LocalizationBuild build);
+        void Publish(std::unique_ptr<const detail::LocalizationSnapshot> snapshot);
+        void ScheduleUpdate();
+
+#ifdef HAS_MHOOKS_LIB
+        void OnStartFrame(const GameDllStartFrameMChain& chain);
+#endif
     };
 
     template <typename... Args>
     FORCEINLINE std::string Localization::GetTextFormat(const std::string& lang, const std::string_view label, Args&&... args) const
     {
-        return str::Format(GetText(lang, label), std::forward<Args>(args)...);
+        const auto scope = Pin();
+        return str::Format(GetText(lang, label).c_str(), std::forward<Args>(args)...);
     }
 
     template <typename... Args>
     FORCEINLINE std::string Localization::GetTextFormat(const std::string& lang, const std::string_view label,
                                                         cssdk::Edict* const client, Args&&... args) const
     {
-        return str::Format(GetText(lang, label, client), std::forward<Args>(args)...);
+        const auto scope = Pin();
+        return str::Format(GetText(lang, label, client).c_str(), std::forward<Args>(args)...);
     }
+
+    template <typename... Args>
+    FORCEINLINE std::string Localization::GetTextFormat(const std::string& lang, const LocLabel label,
+                                                        cssdk::Edict* const client, Args&&... args) const
+    {
+        const auto scope = Pin();
+        return str::Format(GetText(lang, label, client).c_str(), std::forward<Args>(args)...);
+    }
+
+#ifdef HAS_MHOOKS_LIB
+    template <std::size_t Capacity, bool AllClients, typename Send, typename... Args>
+    void Localization::Broadcast(const LocLabel label, Send&& send, const Args&... args) const
+    {
+        const auto scope = Pin();
+        detail::LocalizationPlayerGroups groups{};
+        GroupPlayers(label, groups);
+
+        for (std::size_t group = 0; group < groups.group_count; ++group) {
+            str::FixedString<Capacity> text;
+            str::FormatTo(text, groups.texts[group], args...);
+
+            if (AllClients && groups.group_count == 1) {
+                send(nullptr, static_cast<str::CStringView>(text));
+                break;
+            }
+
+            for (auto i = groups.offsets[group]; i < groups.offsets[group + 1]; ++i) {
+                send(groups.players[i], static_cast<str::CStringView>(text));
+            }
+        }
+    }
+#endif
 }
 #endif
@@ -19,31 +19,277 @@
 
 #if defined(HAS_AMXX_LIB) && defined(HAS_METAMOD_LIB) && defined(HAS_MHOOKS_LIB)
 #include <core/delegate.h>
+#include <core/inplace_function.h>
+#include <core/strings/cstring_view.h>
 #include <core/type_conversion.h>
 #include <cssdk/public/utils.h>
 #include <mhooks/messages.h>
 #include <mhooks/metamod.h>
 #include <array>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
 #include <string_view>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace core
 {
     /**
-     * @brief Menu handler delegate.
+     * @brief Menu handler: a \c Delegate, or any callable that fits in an \c InplaceFunction.
     */
-    using MenuHandler = Delegate<void(cssdk::Edict* client, int selected_item)>;
+    using MenuHandler = InplaceFunction<void(cssdk::Edict* client, int selected_item)>;
 
-    class Menu
+    class Menu;
+
+    /**
+     * @brief Pre-serialized menu: the UTF-8 truncated text already split into ShowMenu chunks.
+     * Sending a page only replays the chunk writes, so a plugin that shows the same menu repeatedly
+     * can build the page once and keep it.
+    */
+    class MenuPage
     {
-        MenuHandler handler_;
+        std::string chunks_{};
+        std::vector<std::uint32_t> chunk_offsets_{};
+        std::size_t hash_{};
+        std::size_t message_size_{};
+        int keys_{};
+
+    public:
+        /**
+         * @brief Maximum length of the menu text in bytes; longer texts are truncated.
+        */
+        static constexpr std::size_t TEXT_MAX_LENGTH = 507;
+
+        /**
+         * @brief Maximum length of the text in one ShowMenu message.
+        */
+        static constexpr std::size_t CHUNK_MAX_LENGTH = 172; // Max 187
+
+        /**
+         * @brief Constructor.
+         *
+         * @param keys The key mask (bit 0 is key 1, bit 9 is key 0).
+         * @param text The menu text.
+        */
+        MenuPage(int keys, std::string_view text);
+
+        /**
+         * @brief Rebuilds the page with the specified keys and text, reusing the allocated buffers.
+        */
+        void Assign(int keys, std::string_view text);
+
+        /**
+         * @brief Returns the key mask.
+        */
+        [[nodiscard]] int Keys() const noexcept
+        {
+            return keys_;
+        }
+
+        /**
+         * @brief Returns the hash of the chunks and the key mask.
+        */
+        [[nodiscard]] std::size_t Hash() const noexcept
+        {
+            return hash_;
+        }
+
+        /**
+         * @brief Returns the size in bytes of the ShowMenu messages payload.
+        */
+        [[nodiscard]] std::size_t MessageSize() const noexcept
+        {
+            return message_size_;
+        }
+
+        /**
+         * @brief Returns the number of ShowMenu messages needed to send the page (at least one).
+        */
+        [[nodiscard]] std::size_t ChunkCount() const noexcept
+        {
+            return chunk_offsets_.size() - 1;
+        }
+
+        /**
+         * @brief Returns the null-terminated text of the chunk at the specified index.
+        */
+        [[nodiscard]] str::CStringView Chunk(const std::size_t index) const noexcept
+        {
+            assert(index < ChunkCount());
+            return {chunks_.data() + chunk_offsets_[index], chunk_offsets_[index + 1] - chunk_offsets_[index] - 1};
+        }
+    };
+
+    /**
+     * @brief Process-wide menu dispatcher.
+     *
+     * Installs the menu hooks once for all menus and keeps the menu that is currently open for each player,
+     * so a \c menuselect command is routed to exactly one menu and the per-frame cost does not depend
+     * on the number of menus.
+     *
+     * A menu is considered closed when another menu is sent to the player (any ShowMenu or VGUIMenu message,
+     * including the menus of AMXX plugins), when the player disconnects, or on map change. Polling the AMXX
+     * menu state of the players is an optional fallback, see \c SetPollInterval.
+    */
+    class MenuManager
+    {
+        friend class Menu;
+        friend class ItemMenu;
+
         std::vector<std::unique_ptr<mhooks::MHook>> hooks_{};
+        std::unique_ptr<mhooks::MHook> start_frame_hook_{};
+        int poll_interval_{};
+        int frames_until_poll_{};
+
+        struct CachedPage
+        {
+            std::size_t hash{};
+            int keys{};
+            std::string text{};
+            std::shared_ptr<MenuPage> page{};
+        };
+
+        // Pages of the texts shown by Menu::Show, the most recently used first.
+        std::list<CachedPage> page_cache_{};
+        std::unordered_map<std::size_t, std::list<CachedPage>::iterator> page_cache_index_{};
 
+        // Page that ItemMenu renders into; busy while it is being sent.
+        MenuPage scratch_page_{0, {}};
+        bool scratch_page_busy_{};
+
+        std::array<Menu*, cssdk::MAX_CLIENTS + 1> active_menus_{};
         std::array<int, cssdk::MAX_CLIENTS + 1> keys_{};
+        std::array<std::size_t, cssdk::MAX_CLIENTS + 1> page_hashes_{};
+        std::uint64_t saved_bytes_{};
         std::array<int*, cssdk::MAX_CLIENTS + 1> player_prop_menu_{};
         std::array<int*, cssdk::MAX_CLIENTS + 1> player_prop_newmenu_{};
 
+        MenuManager();
+
+    public:
+        /**
+         * @brief Returns the manager instance. The hooks are installed on the first call.
+        */
+        [[nodiscard]] static MenuManager& Instance();
+
+        /**
+         * @brief Copy constructor.
+        */
+        MenuManager(const MenuManager&) = delete;
+
+        /**
+         * @brief Move constructor.
+        */
+        MenuManager(MenuManager&&) = delete;
+
+        /**
+         * @brief Copy assignment operator.
+        */
+        MenuManager& operator=(const MenuManager&) = delete;
+
+        /**
+         * @brief Move assignment operator.
+        */
+        MenuManager& operator=(MenuManager&&) = delete;
+
+        /**
+         * @brief Returns the menu that is open for the specified player, or \c nullptr if there is none.
+        */
+        [[nodiscard]] Menu* ActiveMenu(const int player) const
+        {
+            assert(cssdk::IsClient(player));
+            return active_menus_[player];
+        }
+
+        /**
+         * @brief Returns the keys of the menu that is open for the specified player, or \c 0 if there is none.
+        */
+        [[nodiscard]] int ActiveKeys(const int player) const
+        {
+            assert(cssdk::IsClient(player));
+            return keys_[player];
+        }
+
+        /**
+         * @brief Returns the number of bytes not sent because a menu was shown again to a player
+         * that was still displaying the same text and keys.
+        */
+        [[nodiscard]] std::uint64_t SavedBytes() const noexcept
+        {
+            return saved_bytes_;
+        }
+
+        /**
+         * @brief Resets the saved bytes counter.
+        */
+        void ResetSavedBytes() noexcept
+        {
+            saved_bytes_ = 0;
+        }
+
+        /**
+         * @brief Maximum number of cached pages; the least recently used page is replaced when it is full.
+        */
+        static constexpr std::size_t PAGE_CACHE_CAPACITY = 256;
+
+        /**
+         * @brief Returns the page with the specified keys and text, creating and caching it if needed.
+         * Repeated calls with the same keys and text skip the truncation and the chunking.
+        */
+        [[nodiscard]] std::shared_ptr<const MenuPage> GetPage(int keys, std::string_view text);
+
+        /**
+         * @brief Clears the page cache.
+        */
+        void ClearPageCache()
+        {
+            page_cache_.clear();
+            page_cache_index_.clear();
+        }
+
+        /**
+         * @brief Returns the interval of the AMXX menu state polling in frames, or \c 0 if polling is disabled.
+        */
+        [[nodiscard]] int PollInterval() const noexcept
+        {
+            return poll_interval_;
+        }
+
+        /**
+         * @brief Enables polling of the AMXX menu state of the players with an open menu every \c frames
+         * frames (\c 0 disables polling, the default). Only needed if a plugin changes the menu of a player
+         * without sending a ShowMenu or VGUIMenu message.
+        */
+        void SetPollInterval(int frames);
+
+    private:
+        MenuPage* AcquireScratchPage(int keys, std::string_view text);
+        void ReleaseScratchPage() noexcept;
+        void Open(int player, Menu* menu, const MenuPage& page);
+        bool SkipRedraw(int player, const Menu* menu, const MenuPage& page, int time);
+        void Close(int player);
+        void Detach(const Menu* menu);
+        void Relocate(const Menu* from, Menu* to);
+        void InitPlayerProps();
+        void OnServerActivatePost(const GameDllServerActivateMChain& chain, cssdk::Edict* edict_list, int edict_count, int client_max);
+        void OnShowMenu(cssdk::MessageType type, int id, const float* origin, const cssdk::Edict* client, const mhooks::MessageArgs& args);
+        void OnClientCommand(const GameDllClientCommandMChain& chain, cssdk::Edict* client);
+        void OnClientDisconnect(const GameDllClientDisconnectMChain& chain, cssdk::Edict* client);
+        void OnStartFrame(const GameDllStartFrameMChain& chain);
+        void PollPlayerMenus();
+    };
+
+    class Menu
+    {
+        friend class MenuManager;
+
+        MenuHandler handler_;
+
     public:
         /**
          * @brief Constructor.
@@ -55,7 +301,7 @@ namespace core
         /**
          * @brief Destructor.
         */
-        ~Menu() = default;
+        ~Menu();
 
         /**
          * @brief Move constructor.
@@ -79,6 +325,8 @@ namespace core
 
         /**
          * @brief Displays the menu to one client. Returns \c true if successful; \c false otherwise.
+         *
+         * @note The page of the text is cached, so showing the same text again skips its preparation.
         */
         bool Show(cssdk::Edict* client, int keys, std::string_view text, int time = -1);
 
@@ -87,6 +335,19 @@ namespace core
         */
         bool Show(int keys, std::string_view text, int time = -1);
 
+        /**
+         * @brief Displays the menu page to one client. Returns \c true if successful; \c false otherwise.
+         *
+         * @note If the client is still displaying this menu with the same text and keys, and the menu has
+         * no timeout, nothing is sent.
+        */
+        bool Show(cssdk::Edict* client, const MenuPage& page, int time = -1);
+
+        /**
+         * @brief Displays the menu page to all clients. Returns \c true if successful; \c false otherwise.
+        */
+        bool Show(const MenuPage& page, int time = -1);
+
         /**
          * @brief Closes the menu for the specified player (or all players if \c client is \c nullptr).
         */
@@ -95,9 +356,9 @@ namespace core
         /**
          * @brief Sets the menu handler function.
         */
-        void SetHandler(const MenuHandler handler)
+        void SetHandler(MenuHandler handler)
         {
-            handler_ = handler;
+            handler_ = std::move(handler);
         }
 
         /**
@@ -115,8 +376,7 @@ namespace core
         */
         [[nodiscard]] bool IsOpen(const int player) const
         {
-            assert(cssdk::IsClient(player));
-            return keys_[player] != 0;
+            return MenuManager::Instance().ActiveMenu(player) == this;
         }
 
         /**
@@ -134,14 +394,183 @@ namespace core
         {
             return IsOpen(type_conversion::IndexOfEntity(player));
         }
+    };
+
+    /**
+     * @brief Paginated menu of items.
+     *
+     * Holds the item model and the page viewed by each player. A page is rendered when it is shown;
+     * the key mask is computed from the enabled items and the Back/Next/Exit keys are handled by the menu.
+     * Items use keys \c 1 to \c 7, \c 8 is Back, \c 9 is Next and \c 0 is Exit.
+    */
+    class ItemMenu
+    {
+    public:
+        /**
+         * @brief Item selection handler: receives the index of the selected item, or \c EXIT if the menu was exited.
+        */
+        using ItemHandler = InplaceFunction<void(cssdk::Edict* client, std::size_t item)>;
+
+        /**
+         * @brief Returns \c true if the item can be selected by the client.
+        */
+        using ItemEnabled = InplaceFunction<bool(cssdk::Edict* client)>;
+
+        /**
+         * @brief Item index passed to the handler when the menu is exited.
+        */
+        static constexpr std::size_t EXIT = SIZE_MAX;
+
+        /**
+         * @brief Number of items on a page.
+        */
+        static constexpr std::size_t ITEMS_PER_PAGE = 7;
 
     private:
-        void CreateHooks();
-        void InitPlayerProps();
-        void OnServerActivatePost(const GameDllServerActivateMChain& chain, cssdk::Edict* edict_list, int edict_count, int client_max);
-        void OnShowMenu(cssdk::MessageType type, int id, const float* origin, const cssdk::Edict* client, const mhooks::MessageArgs& args);
-        void OnClientCommand(const GameDllClientCommandMChain& chain, cssdk::Edict* client);
-        void OnPlayerPreThink(const GameDllPlayerPreThinkMChain& chain, cssdk::Edict* client);
+        struct Item
+        {
+            std::string text;
+            ItemEnabled enabled;
+        };
+
+        Menu menu_;
+        ItemHandler handler_;
+        std::string title_;
+        std::vector<Item> items_{};
+        std::string back_text_{"Back"};
+        std::string next_text_{"Next"};
+        std::string exit_text_{"Exit"};
+        std::array<std::uint32_t, cssdk::MAX_CLIENTS + 1> pages_{};
+        std::string buffer_{};
+
+    public:
+        /**
+         * @brief Constructor.
+         *
+         * @param title The menu title.
+         * @param handler The item selection handler.
+        */
+        explicit ItemMenu(std::string title = {}, ItemHandler handler = nullptr);
+
+        /**
+         * @brief Destructor.
+        */
+        ~ItemMenu() = default;
+
+        /**
+         * @brief Move constructor.
+        */
+        ItemMenu(ItemMenu&&) = delete;
+
+        /**
+         * @brief Copy constructor.
+        */
+        ItemMenu(const ItemMenu&) = delete;
+
+        /**
+         * @brief Move assignment operator.
+        */
+        ItemMenu& operator=(ItemMenu&&) = delete;
+
+        /**
+         * @brief Copy assignment operator.
+        */
+        ItemMenu& operator=(const ItemMenu&) = delete;
+
+        /**
+         * @brief Sets the menu title.
+        */
+        void SetTitle(std::string title)
+        {
+            title_ = std::move(title);
+        }
+
+        /**
+         * @brief Sets the item selection handler.
+        */
+        void SetHandler(ItemHandler handler)
+        {
+            handler_ = std::move(handler);
+        }
+
+        /**
+         * @brief Sets the texts of the navigation items.
+        */
+        void SetNavigationTexts(std::string back, std::string next, std::string exit);
+
+        /**
+         * @brief Adds an item and returns its index.
+         *
+         * @param text The item text.
+         * @param enabled Returns \c true if the item can be selected by a client; \c nullptr if always enabled.
+        */
+        std::size_t AddItem(std::string text, ItemEnabled enabled = nullptr);
+
+        /**
+         * @brief Removes all the items.
+        */
+        void ClearItems()
+        {
+            items_.clear();
+        }
+
+        /**
+         * @brief Returns the number of items.
+        */
+        [[nodiscard]] std::size_t ItemCount() const noexcept
+        {
+            return items_.size();
+        }
+
+        /**
+         * @brief Returns the number of pages (at least one).
+        */
+        [[nodiscard]] std::size_t PageCount() const noexcept
+        {
+            return items_.empty() ? 1 : (items_.size() + ITEMS_PER_PAGE - 1) / ITEMS_PER_PAGE;
+        }
+
+        /**
+         * @brief Returns the page last shown to the specified player.
+        */
+        [[nodiscard]] std::size_t Page(const int player) const
+        {
+            assert(cssdk::IsClient(player));
+            return pages_[player];
+        }
+
+        /**
+         * @brief Displays the page to the client. Returns \c true if successful; \c false otherwise.
+        */
+        bool Show(cssdk::Edict* client, std::size_t page = 0, int time = -1);
+
+        /**
+         * @brief Closes the menu for the specified player (or all players if \c client is \c nullptr).
+        */
+        void Close(cssdk::Edict* const client)
+        {
+            menu_.Close(client);
+        }
+
+        /**
+         * @brief Returns \c true if the menu is open for the specified player; \c false otherwise.
+        */
+        [[nodiscard]] bool IsOpen(const int player) const
+        {
+            return menu_.IsOpen(player);
+        }
+
+        /**
+         * @brief Returns \c true if the menu is open for the specified player; \c false otherwise.
+        */
+        [[nodiscard]] bool IsOpen(const cssdk::Edict* const player) const
+        {
+            return menu_.IsOpen(player);
+        }
+
+    private:
+        int Render(cssdk::Edict* client, std::size_t page);
+        void OnSelect(cssdk::Edict* client, int selected_item);
     };
 }
 #endif
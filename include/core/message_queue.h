@@ -0,0 +1,255 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#if defined(HAS_METAMOD_LIB) && defined(HAS_MHOOKS_LIB)
+#include <core/messages.h>
+#include <core/player_set.h>
+#include <core/strings/cstring_view.h>
+#include <cssdk/dll/cdll_dll.h>
+#include <cssdk/engine/edict.h>
+#include <cssdk/public/utils.h>
+#include <mhooks/metamod.h>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace core::messages
+{
+    /**
+     * @brief Counters of the \c MessageQueue.
+    */
+    struct MessageQueueStats
+    {
+        /**
+         * @brief Number of messages queued for a client (a message sent to several clients counts once per client).
+        */
+        std::size_t posted{};
+
+        /**
+         * @brief Number of queued HUD messages dropped because a newer one was queued on the same channel.
+        */
+        std::size_t superseded{};
+
+        /**
+         * @brief Number of messages sent to the clients.
+        */
+        std::size_t sent{};
+
+        /**
+         * @brief Number of messages left over by the byte budget and carried to the next frame.
+        */
+        std::size_t carried{};
+    };
+
+    /**
+     * @brief Optional deferred send queue of the core messages.
+     *
+     * While the queue is enabled, \c SendTextMessage, \c SendChatMessage, \c SendChatColorMessage and
+     * \c SendHudMessage do not write the message immediately: it is stored for each recipient in a per-frame
+     * arena and sent at the start of the next frame, before the game logic of the frame runs. A queued HUD
+     * message is dropped when a newer one is queued for the same client and channel. Each client is sent at most
+     * \c ClientBudget bytes per frame, the rest of its queue is carried to the next frame in order.
+     *
+     * Messages to all clients are queued per client, so they are sent as one-client messages.
+    */
+    class MessageQueue final
+    {
+        enum class Kind : std::uint8_t
+        {
+            TextMsg,
+            SayText,
+            Hud
+        };
+
+        struct Entry
+        {
+            Kind kind;
+            int arg;
+            std::uint32_t text_offset;
+            std::uint32_t text_length;
+            std::uint32_t size;
+            cssdk::HudTextParams hud_params;
+        };
+
+        inline static bool collecting_{};
+
+        std::vector<std::unique_ptr<mhooks::MHook>> hooks_{};
+        std::unique_ptr<mhooks::MHook> start_frame_hook_{};
+
+        // Queued messages of each client in the order they were posted.
+        std::array<std::vector<Entry>, cssdk::MAX_CLIENTS + 1> queues_{};
+
+        // Null-terminated texts of the queued messages. The leftovers are compacted into the spare arena
+        // on flush, then the arenas are swapped; their storage is reused from frame to frame.
+        std::string arena_{};
+        std::string spare_arena_{};
+
+        std::size_t client_budget_{DEFAULT_CLIENT_BUDGET};
+        std::size_t pending_{};
+        MessageQueueStats stats_{};
+        bool enabled_{};
+
+        MessageQueue();
+
+    public:
+        /**
+         * @brief Default number of bytes sent to a client per frame.
+        */
+        static constexpr std::size_t DEFAULT_CLIENT_BUDGET = 1024;
+
+        /**
+         * @brief Returns the queue instance. The hooks are installed on the first call.
+        */
+        [[nodiscard]] static MessageQueue& Instance();
+
+        /**
+         * @brief Copy constructor.
+        */
+        MessageQueue(const MessageQueue&) = delete;
+
+        /**
+         * @brief Move constructor.
+        */
+        MessageQueue(MessageQueue&&) = delete;
+
+        /**
+         * @brief Copy assignment operator.
+        */
+        MessageQueue& operator=(const MessageQueue&) = delete;
+
+        /**
+         * @brief Move assignment operator.
+        */
+        MessageQueue& operator=(MessageQueue&&) = delete;
+
+        /**
+         * @brief Returns \c true if the messages are queued instead of being sent immediately.
+         * Checked by the send functions; \c false while the queue is flushed.
+        */
+        [[nodiscard]] static bool IsCollecting() noexcept
+        {
+            return collecting_;
+        }
+
+        /**
+         * @brief Returns \c true if the queue is enabled.
+        */
+        [[nodiscard]] bool IsEnabled() const noexcept
+        {
+            return enabled_;
+        }
+
+        /**
+         * @brief Enables or disables the queue (disabled by default).
+         * When the queue is disabled, the queued messages are sent immediately regardless of the byte budget.
+        */
+        void SetEnabled(bool enabled);
+
+        /**
+         * @brief Returns the number of bytes sent to a client per frame, or \c 0 if it is unlimited.
+        */
+        [[nodiscard]] std::size_t ClientBudget() const noexcept
+        {
+            return client_budget_;
+        }
+
+        /**
+         * @brief Sets the number of bytes sent to a client per frame (\c 0 means unlimited).
+         * The first queued message of a client is sent even if it is larger than the budget.
+        */
+        void SetClientBudget(const std::size_t bytes) noexcept
+        {
+            client_budget_ = bytes;
+        }
+
+        /**
+         * @brief Returns the number of queued messages of all clients.
+        */
+        [[nodiscard]] std::size_t Pending() const noexcept
+        {
+            return pending_;
+        }
+
+        /**
+         * @brief Returns the number of queued messages of the specified client.
+        */
+        [[nodiscard]] std::size_t Pending(const int client) const
+        {
+            assert(cssdk::IsClient(client));
+            return queues_[client].size();
+        }
+
+        /**
+         * @brief Returns the counters.
+        */
+        [[nodiscard]] const MessageQueueStats& Stats() const noexcept
+        {
+            return stats_;
+        }
+
+        /**
+         * @brief Resets the counters.
+        */
+        void ResetStats() noexcept
+        {
+            stats_ = {};
+        }
+
+        /**
+         * @brief Sends the queued messages within the byte budget of each client now.
+         * Called at the start of each frame while the queue is not empty.
+        */
+        void Flush();
+
+        /**
+         * @brief Drops all queued messages.
+        */
+        void Clear();
+
+        /**
+         * @brief Queues a text message for the specified clients.
+        */
+        void PostTextMessage(const PlayerSet& clients, cssdk::HudPrint dest, str::CStringView text);
+
+        /**
+         * @brief Queues a chat message for the specified clients.
+        */
+        void PostChatMessage(const PlayerSet& clients, int sender, str::CStringView text);
+
+        /**
+         * @brief Queues a HUD message for the specified clients.
+        */
+        void PostHudMessage(const PlayerSet& clients, const cssdk::HudTextParams& hud_params, str::CStringView text);
+
+    private:
+        void Post(const PlayerSet& clients, Kind kind, int arg, const cssdk::HudTextParams& hud_params,
+                  str::CStringView text, std::size_t max_length);
+        void FlushClient(int client, std::size_t budget);
+        void ClearClient(int client);
+        void UpdateStartFrameHook();
+        void OnStartFrame(const GameDllStartFrameMChain& chain);
+        void OnClientDisconnect(const GameDllClientDisconnectMChain& chain, cssdk::Edict* client);
+        void OnServerDeactivatePost(const GameDllServerDeactivateMChain& chain);
+    };
+}
+#endif
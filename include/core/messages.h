@@ -18,14 +18,40 @@
 #pragma once
 
 #ifdef HAS_METAMOD_LIB
+#include <core/player_set.h>
+#include <core/strings/cstring_view.h>
+#include <core/strings/fixed_string.h>
 #include <core/strings/format.h>
 #include <cssdk/common/const.h>
 #include <cssdk/dll/cdll_dll.h>
 #include <cssdk/engine/edict.h>
 #include <cssdk/public/os_defs.h>
+#include <cstddef>
+#include <utility>
 
 namespace core::messages
 {
+    /**
+     * @brief Maximum length of the text in the TextMsg and SayText messages.
+    */
+    constexpr std::size_t TEXT_MAX_LENGTH = 190;
+
+    /**
+     * @brief Maximum length of the text in the HUD message.
+     * The maximum net message size is 512 bytes. There are only 489 bytes left for the string.
+    */
+    constexpr std::size_t HUD_TEXT_MAX_LENGTH = 489;
+
+    /**
+     * @brief Stack buffer for the text of the TextMsg and SayText messages.
+    */
+    using TextString = str::FixedString<TEXT_MAX_LENGTH>;
+
+    /**
+     * @brief Stack buffer for the text of the HUD message.
+    */
+    using HudTextString = str::FixedString<HUD_TEXT_MAX_LENGTH>;
+
     enum class SayTextTeamColor
     {
         /**
@@ -52,36 +78,64 @@ namespace core::messages
     /**
      * @brief Sends a text message to clients.
     */
-    void SendTextMessage(cssdk::Edict* client, cssdk::HudPrint dest, const std::string& text);
+    void SendTextMessage(cssdk::Edict* client, cssdk::HudPrint dest, str::CStringView text);
 
     /**
      * @brief Sends chat message to clients.
     */
-    void SendChatMessage(cssdk::Edict* client, int sender, const std::string& text);
+    void SendChatMessage(cssdk::Edict* client, int sender, str::CStringView text);
 
     /**
      * @brief Sends colored chat message to clients.
     */
-    void SendChatColorMessage(cssdk::Edict* client, const std::string& text,
+    void SendChatColorMessage(cssdk::Edict* client, str::CStringView text,
                               SayTextTeamColor color = SayTextTeamColor::Default);
     /**
      * @brief Sends colored chat message to clients.
     */
-    void SendChatColorMessage(cssdk::Edict* client, int sender, const std::string& text,
+    void SendChatColorMessage(cssdk::Edict* client, int sender, str::CStringView text,
                               SayTextTeamColor color = SayTextTeamColor::Default);
     /**
      * @brief Sends a HUD message to clients.
     */
-    void SendHudMessage(cssdk::Edict* client, const cssdk::HudTextParams& hud_params, const std::string& text);
+    void SendHudMessage(cssdk::Edict* client, const cssdk::HudTextParams& hud_params, str::CStringView text);
+
+#ifdef HAS_MHOOKS_LIB
+    /**
+     * @brief Sends a text message to the specified set of clients.
+     * The message is sent once to all clients if the set contains every connected player.
+    */
+    void SendTextMessage(const PlayerSet& clients, cssdk::HudPrint dest, str::CStringView text);
+
+    /**
+     * @brief Sends chat message to the specified set of clients.
+     * The message is sent once to all clients if the set contains every connected player.
+    */
+    void SendChatMessage(const PlayerSet& clients, int sender, str::CStringView text);
+
+    /**
+     * @brief Sends colored chat message to the specified set of clients.
+     * The message is sent once to all clients if the set contains every connected player.
+    */
+    void SendChatColorMessage(const PlayerSet& clients, int sender, str::CStringView text,
+                              SayTextTeamColor color = SayTextTeamColor::Default);
+
+    /**
+     * @brief Sends a HUD message to the specified set of clients.
+     * The message is sent once to all clients if the set contains every connected player.
+    */
+    void SendHudMessage(const PlayerSet& clients, const cssdk::HudTextParams& hud_params, str::CStringView text);
+#endif
 
     /**
      * @brief Sends a text message to clients.
     */
     template <typename... Args>
     ATTR_MINSIZE void SendTextMessage(cssdk::Edict* const client, const cssdk::HudPrint dest,
-                                      const std::string& format, Args&&... args)
+                                      const str::CStringView format, Args&&... args)
     {
-        const auto& text = str::Format(format, std::forward<Args>(args)...);
+        TextString text;
+        str::FormatTo(text, format, std::forward<Args>(args)...);
         SendTextMessage(client, dest, text);
     }
 
@@ -90,9 +144,10 @@ namespace core::messages
     */
     template <typename... Args>
     ATTR_MINSIZE void SendChatMessage(cssdk::Edict* const client, const int sender,
-                                      const std::string& format, Args&&... args)
+                                      const str::CStringView format, Args&&... args)
     {
-        const auto& text = str::Format(format, std::forward<Args>(args)...);
+        TextString text;
+        str::FormatTo(text, format, std::forward<Args>(args)...);
         SendChatMessage(client, sender, text);
     }
 
@@ -101,9 +156,10 @@ namespace core::messages
     */
     template <SayTextTeamColor Color = SayTextTeamColor::Default, typename... Args>
     ATTR_MINSIZE void SendChatColorMessage(cssdk::Edict* const client,
-                                           const std::string& format, Args&&... args)
+                                           const str::CStringView format, Args&&... args)
     {
-        const auto& text = str::Format(format, std::forward<Args>(args)...);
+        TextString text;
+        str::FormatTo(text, format, std::forward<Args>(args)...);
         SendChatColorMessage(client, text, Color);
     }
 
@@ -112,9 +168,10 @@ namespace core::messages
     */
     template <SayTextTeamColor Color = SayTextTeamColor::Default, typename... Args>
     ATTR_MINSIZE void SendChatColorMessage(cssdk::Edict* const client, const int sender,
-                                           const std::string& format, Args&&... args)
+                                           const str::CStringView format, Args&&... args)
     {
-        const auto& text = str::Format(format, std::forward<Args>(args)...);
+        TextString text;
+        str::FormatTo(text, format, std::forward<Args>(args)...);
         SendChatColorMessage(client, sender, text, Color);
     }
 
@@ -123,10 +180,61 @@ namespace core::messages
     */
     template <typename... Args>
     ATTR_MINSIZE void SendHudMessage(cssdk::Edict* const client, const cssdk::HudTextParams& hud_params,
-                                     const std::string& format, Args&&... args)
+                                     const str::CStringView format, Args&&... args)
     {
-        const auto& text = str::Format(format, std::forward<Args>(args)...);
+        HudTextString text;
+        str::FormatTo(text, format, std::forward<Args>(args)...);
         SendHudMessage(client, hud_params, text);
     }
+
+#ifdef HAS_MHOOKS_LIB
+    /**
+     * @brief Sends a text message to the specified set of clients.
+    */
+    template <typename... Args>
+    ATTR_MINSIZE void SendTextMessage(const PlayerSet& clients, const cssdk::HudPrint dest,
+                                      const str::CStringView format, Args&&... args)
+    {
+        TextString text;
+        str::FormatTo(text, format, std::forward<Args>(args)...);
+        SendTextMessage(clients, dest, text);
+    }
+
+    /**
+     * @brief Sends chat message to the specified set of clients.
+    */
+    template <typename... Args>
+    ATTR_MINSIZE void SendChatMessage(const PlayerSet& clients, const int sender,
+                                      const str::CStringView format, Args&&... args)
+    {
+        TextString text;
+        str::FormatTo(text, format, std::forward<Args>(args)...);
+        SendChatMessage(clients, sender, text);
+    }
+
+    /**
+     * @brief Sends colored chat message to the specified set of clients.
+    */
+    template <SayTextTeamColor Color = SayTextTeamColor::Default, typename... Args>
+    ATTR_MINSIZE void SendChatColorMessage(const PlayerSet& clients, const int sender,
+                                           const str::CStringView format, Args&&... args)
+    {
+        TextString text;
+        str::FormatTo(text, format, std::forward<Args>(args)...);
+        SendChatColorMessage(clients, sender, text, Color);
+    }
+
+    /**
+     * @brief Sends a HUD message to the specified set of clients.
+    */
+    template <typename... Args>
+    ATTR_MINSIZE void SendHudMessage(const PlayerSet& clients, const cssdk::HudTextParams& hud_params,
+                                     const str::CStringView format, Args&&... args)
+    {
+        HudTextString text;
+        str::FormatTo(text, format, std::forward<Args>(args)...);
+        SendHudMessage(clients, hud_params, text);
+    }
+#endif
 }
 #endif
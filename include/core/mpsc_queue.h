@@ -0,0 +1,184 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace core
+{
+    /**
+     * @brief Bounded lock-free multi-producer single-consumer queue.
+     *
+     * Any thread can push; only one thread (the consumer) can pop. Every cell carries a sequence number
+     * that tells producers and the consumer whether the cell is free or filled, so no locks are taken
+     * and no memory is allocated after construction.
+    */
+    template <typename T>
+    class MpscQueue
+    {
+        // Keeps the producer and consumer positions on separate cache lines.
+        static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+        struct Cell
+        {
+            std::atomic<std::size_t> sequence;
+            std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+        };
+
+        std::unique_ptr<Cell[]> cells_;
+        std::size_t mask_;
+        alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> push_position_{};
+        alignas(CACHE_LINE_SIZE) std::size_t pop_position_{};
+
+    public:
+        /**
+         * @brief Constructor.
+         *
+         * @param capacity The maximum number of queued items (rounded up to a power of two, at least 2).
+        */
+        explicit MpscQueue(const std::size_t capacity)
+            : cells_(std::make_unique<Cell[]>(RoundCapacity(capacity))), mask_(RoundCapacity(capacity) - 1)
+        {
+            for (std::size_t i = 0; i <= mask_; ++i) {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief Destructor.
+        */
+        ~MpscQueue()
+        {
+            while (TryPop([](T&&) {})) {
+            }
+        }
+
+        /**
+         * @brief Copy constructor.
+        */
+        MpscQueue(const MpscQueue&) = delete;
+
+        /**
+         * @brief Move constructor.
+        */
+        MpscQueue(MpscQueue&&) = delete;
+
+        /**
+         * @brief Copy assignment operator.
+        */
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        /**
+         * @brief Move assignment operator.
+        */
+        MpscQueue& operator=(MpscQueue&&) = delete;
+
+        /**
+         * @brief Returns the maximum number of queued items.
+        */
+        [[nodiscard]] std::size_t Capacity() const noexcept
+        {
+            return mask_ + 1;
+        }
+
+        /**
+         * @brief Constructs an item at the end of the queue. Can be called from any thread.
+         *
+         * @return \c false if the queue is full; the item is not constructed in this case.
+        */
+        template <typename... ItemArgs>
+        bool TryPush(ItemArgs&&... args)
+        {
+            auto position = push_position_.load(std::memory_order_relaxed);
+
+            for (;;) {
+                auto& cell = cells_[position & mask_];
+                const auto sequence = cell.sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+
+                if (difference == 0) {
+                    if (push_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        ::new (&cell.storage) T(std::forward<ItemArgs>(args)...);
+                        cell.sequence.store(position + 1, std::memory_order_release);
+
+                        return true;
+                    }
+                }
+                else if (difference < 0) {
+                    // The cell still holds an item from the previous lap.
+                    return false;
+                }
+                else {
+                    position = push_position_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * @brief Removes the first item and passes it to the consumer. Must be called from the consumer thread only.
+         *
+         * @return \c false if the queue is empty (or the first item is not fully pushed yet).
+        */
+        template <typename Consumer>
+        bool TryPop(Consumer&& consumer)
+        {
+            auto& cell = cells_[pop_position_ & mask_];
+
+            if (cell.sequence.load(std::memory_order_acquire) != pop_position_ + 1) {
+                return false;
+            }
+
+            auto* const item = std::launder(reinterpret_cast<T*>(&cell.storage));
+
+            // Free the cell even if the consumer throws.
+            struct CellRelease
+            {
+                Cell& cell;
+                T* item;
+                std::size_t sequence;
+
+                ~CellRelease()
+                {
+                    item->~T();
+                    cell.sequence.store(sequence, std::memory_order_release);
+                }
+            } release{cell, item, pop_position_ + mask_ + 1};
+
+            ++pop_position_;
+            consumer(std::move(*item));
+
+            return true;
+        }
+
+    private:
+        [[nodiscard]] static std::size_t RoundCapacity(const std::size_t capacity) noexcept
+        {
+            std::size_t result = 2;
+
+            while (result < capacity) {
+                result <<= 1;
+            }
+
+            return result;
+        }
+    };
+}
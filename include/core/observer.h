@@ -18,20 +18,381 @@
 #pragma once
 
 #include <core/delegate.h>
+#include <core/inplace_function.h>
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
-#include <memory>
+#include <functional>
+#include <mutex>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 namespace core
 {
+    /**
+     * @brief Subscription identifier: the slot index in the low 32 bits and the slot generation in the high 32 bits.
+    */
+    using SubscriptionId = std::uint64_t;
+}
+
+namespace core::detail
+{
+    /**
+     * @brief Generation-checked handle of an observable in the \c ObservableRegistry.
+    */
+    struct ObservableHandle
+    {
+        static constexpr std::uint32_t INVALID_INDEX = UINT32_MAX;
+
+        std::uint32_t index{INVALID_INDEX};
+        std::uint32_t generation{};
+    };
+
+    /**
+     * @brief Table of the observables that handed out \c Subscription tokens.
+     *
+     * A token refers to its observable by a handle; the generation of the entry is incremented when the
+     * observable is destroyed, so a token that outlives it is ignored. The table is guarded by a mutex,
+     * so tokens of a \c ConcurrentObservable can be created and dropped on any thread.
+    */
+    class ObservableRegistry
+    {
+    public:
+        using UnsubscribeFunction = void (*)(void* observable, SubscriptionId id);
+
+    private:
+        struct Entry
+        {
+            void* observable;
+            UnsubscribeFunction unsubscribe;
+            std::uint32_t generation;
+            std::uint32_t next_free;
+        };
+
+        mutable std::mutex mutex_{};
+        std::vector<Entry> entries_{};
+        std::uint32_t free_entry_{ObservableHandle::INVALID_INDEX};
+
+        ObservableRegistry() = default;
+
+        [[nodiscard]] bool IsValidLocked(const ObservableHandle handle) const noexcept
+        {
+            return handle.index < entries_.size() && entries_[handle.index].generation == handle.generation &&
+                entries_[handle.index].observable != nullptr;
+        }
+
+    public:
+        /**
+         * @brief Returns the registry instance.
+         *
+         * @note The instance is never destroyed, so tokens held by static objects can be dropped at any time.
+        */
+        [[nodiscard]] static ObservableRegistry& Instance()
+        {
+            static auto* const instance = new ObservableRegistry();
+            return *instance;
+        }
+
+        /**
+         * @brief Registers the observable and returns its handle.
+        */
+        [[nodiscard]] ObservableHandle Register(void* const observable, const UnsubscribeFunction unsubscribe)
+        {
+            const std::lock_guard lock{mutex_};
+            std::uint32_t index;
+
+            if (free_entry_ != ObservableHandle::INVALID_INDEX) {
+                index = free_entry_;
+                free_entry_ = entries_[index].next_free;
+            }
+            else {
+                index = static_cast<std::uint32_t>(entries_.size());
+                entries_.push_back({nullptr, nullptr, 0, ObservableHandle::INVALID_INDEX});
+            }
+
+            auto& entry = entries_[index];
+            entry.observable = observable;
+            entry.unsubscribe = unsubscribe;
+
+            return {index, entry.generation};
+        }
+
+        /**
+         * @brief Updates the address of the registered observable (after it is moved).
+        */
+        void Relocate(const ObservableHandle handle, void* const observable) noexcept
+        {
+            const std::lock_guard lock{mutex_};
+
+            if (IsValidLocked(handle)) {
+                entries_[handle.index].observable = observable;
+            }
+        }
+
+        /**
+         * @brief Unregisters the observable. Tokens that refer to it are ignored from now on.
+        */
+        void Unregister(const ObservableHandle handle) noexcept
+        {
+            const std::lock_guard lock{mutex_};
+
+            if (!IsValidLocked(handle)) {
+                return;
+            }
+
+            auto& entry = entries_[handle.index];
+            ++entry.generation;
+            entry.observable = nullptr;
+            entry.next_free = free_entry_;
+            free_entry_ = handle.index;
+        }
+
+        /**
+         * @brief Unsubscribes from the observable if it is still registered.
+        */
+        void Unsubscribe(const ObservableHandle handle, const SubscriptionId id) const
+        {
+            Entry entry{};
+
+            {
+                const std::lock_guard lock{mutex_};
+
+                if (!IsValidLocked(handle)) {
+                    return;
+                }
+
+                entry = entries_[handle.index];
+            }
+
+            // Called without the lock: unsubscribing may destroy an observer that holds another token.
+            entry.unsubscribe(entry.observable, id);
+        }
+
+        /**
+         * @brief Returns \c true if the handle refers to a registered observable.
+        */
+        [[nodiscard]] bool IsValid(const ObservableHandle handle) const noexcept
+        {
+            const std::lock_guard lock{mutex_};
+            return IsValidLocked(handle);
+        }
+    };
+
+    /**
+     * @brief Base of the observables that return \c Subscription tokens: registers the observable
+     * on the first subscription and keeps the registry up to date when the observable is moved or destroyed.
+    */
+    template <typename Derived>
+    class SubscriptionSource
+    {
+        ObservableHandle handle_{};
+
+    protected:
+        /**
+         * @brief Constructor.
+        */
+        SubscriptionSource() = default;
+
+        /**
+         * @brief Destructor.
+        */
+        ~SubscriptionSource()
+        {
+            ObservableRegistry::Instance().Unregister(handle_);
+        }
+
+        /**
+         * @brief Copy constructor. Tokens keep referring to the original observable.
+        */
+        SubscriptionSource(const SubscriptionSource&) noexcept
+        {
+        }
+
+        /**
+         * @brief Move constructor. Tokens follow the observable.
+        */
+        SubscriptionSource(SubscriptionSource&& other) noexcept
+            : handle_(std::exchange(other.handle_, {}))
+        {
+            ObservableRegistry::Instance().Relocate(handle_, this);
+        }
+
+        /**
+         * @brief Copy assignment operator. Tokens of this observable are detached.
+        */
+        SubscriptionSource& operator=(const SubscriptionSource& other) noexcept
+        {
+            if (this != &other) {
+                ObservableRegistry::Instance().Unregister(std::exchange(handle_, {}));
+            }
+
+            return *this;
+        }
+
+        /**
+         * @brief Move assignment operator. Tokens of this observable are detached, tokens of the other follow it.
+        */
+        SubscriptionSource& operator=(SubscriptionSource&& other) noexcept
+        {
+            if (this != &other) {
+                ObservableRegistry::Instance().Unregister(handle_);
+                handle_ = std::exchange(other.handle_, {});
+                ObservableRegistry::Instance().Relocate(handle_, this);
+            }
+
+            return *this;
+        }
+
+        /**
+         * @brief Returns the handle of the observable, registering it if needed.
+        */
+        [[nodiscard]] ObservableHandle Handle()
+        {
+            if (!ObservableRegistry::Instance().IsValid(handle_)) {
+                handle_ = ObservableRegistry::Instance().Register(this, [](void* const observable, const SubscriptionId id) {
+                    static_cast<Derived*>(static_cast<SubscriptionSource*>(observable))->Unsubscribe(id);
+                });
+            }
+
+            return handle_;
+        }
+    };
+}
+
+namespace core
+{
+    /**
+     * @brief Move-only subscription token. Unsubscribes when destroyed, unless released.
+     *
+     * Dropping a token is O(1) and safe after the observable is destroyed.
+    */
+    class Subscription
+    {
+        detail::ObservableHandle observable_{};
+        SubscriptionId id_{};
+
+    public:
+        /**
+         * @brief Constructor.
+        */
+        Subscription() = default;
+
+        /**
+         * @brief Constructor.
+        */
+        Subscription(const detail::ObservableHandle observable, const SubscriptionId id) noexcept
+            : observable_(observable), id_(id)
+        {
+        }
+
+        /**
+         * @brief Destructor.
+        */
+        ~Subscription()
+        {
+            Reset();
+        }
+
+        /**
+         * @brief Copy constructor.
+        */
+        Subscription(const Subscription&) = delete;
+
+        /**
+         * @brief Move constructor.
+        */
+        Subscription(Subscription&& other) noexcept
+            : observable_(std::exchange(other.observable_, {})), id_(std::exchange(other.id_, {}))
+        {
+        }
+
+        /**
+         * @brief Copy assignment operator.
+        */
+        Subscription& operator=(const Subscription&) = delete;
+
+        /**
+         * @brief Move assignment operator.
+        */
+        Subscription& operator=(Subscription&& other) noexcept
+        {
+            if (this != &other) {
+                Reset();
+                observable_ = std::exchange(other.observable_, {});
+                id_ = std::exchange(other.id_, {});
+            }
+
+            return *this;
+        }
+
+        /**
+         * @brief Returns the subscription identifier.
+        */
+        [[nodiscard]] SubscriptionId Id() const noexcept
+        {
+            return id_;
+        }
+
+        /**
+         * @brief Returns \c true if the token refers to an observable that is still alive.
+        */
+        [[nodiscard]] bool IsActive() const noexcept
+        {
+            return detail::ObservableRegistry::Instance().IsValid(observable_);
+        }
+
+        /**
+         * @brief Unsubscribes and empties the token.
+        */
+        void Reset()
+        {
+            if (observable_.index != detail::ObservableHandle::INVALID_INDEX) {
+                detail::ObservableRegistry::Instance().Unsubscribe(std::exchange(observable_, {}), id_);
+                id_ = {};
+            }
+        }
+
+        /**
+         * @brief Empties the token without unsubscribing and returns the subscription identifier.
+        */
+        SubscriptionId Release() noexcept
+        {
+            observable_ = {};
+            return std::exchange(id_, {});
+        }
+    };
+
     template <typename... Args>
-    class Observable
+    class Observable : public detail::SubscriptionSource<Observable<Args...>>
     {
-        static inline std::int32_t next_id_{};
-        std::vector<std::pair<std::int32_t, Delegate<void(Args...)>>> observers_{};
+        using ObserverDelegate = Delegate<void(Args...)>;
+        using ObserverFunction = InplaceFunction<void(Args...)>;
+
+        static constexpr std::uint32_t INVALID_INDEX = UINT32_MAX;
+        static constexpr std::uint32_t PENDING_FLAG = 0x80000000;
+
+        struct Slot
+        {
+            // Index in the dense arrays (or PENDING_FLAG | index in the pending arrays) if the slot is used,
+            // otherwise the next free slot.
+            std::uint32_t index;
+            std::uint32_t generation;
+        };
+
+        // Slot map: dense arrays are iterated by Notify, slots give stable identifiers.
+        // Observers subscribed during a notification are queued in the pending arrays, so the dense arrays
+        // never grow while they are iterated. Notify is const, so the storage is mutable to apply the deferred
+        // changes after a notification.
+        mutable std::vector<ObserverFunction> observers_{};
+        mutable std::vector<std::uint32_t> observer_slots_{};
+        mutable std::vector<ObserverFunction> pending_observers_{};
+        mutable std::vector<std::uint32_t> pending_slots_{};
+        mutable std::vector<Slot> slots_{};
+        mutable std::uint32_t free_slot_{INVALID_INDEX};
+        mutable std::uint32_t notify_depth_{};
+        mutable std::uint32_t removed_count_{};
 
     public:
         /**
@@ -67,12 +428,39 @@ namespace core
         /**
          * @brief N/D
          *
-         * @return The unique identifier that can be used to unsubscribe.
+         * @param observer A \c Delegate, or any callable that fits in an \c InplaceFunction (e.g. a capturing lambda).
+         *
+         * @note An observer subscribed during a notification is not called until the next one.
+         *
+         * @return The subscription token; the observer is unsubscribed when the token is destroyed.
         */
-        std::int32_t Subscribe(Delegate<void(Args...)>&& observer)
+        [[nodiscard]] Subscription Subscribe(ObserverFunction&& observer)
         {
-            observers_.emplace_back(std::make_pair(next_id_++, std::forward<Delegate<void(Args...)>>(observer)));
-            return observers_.back().first;
+            std::uint32_t slot_index;
+
+            if (free_slot_ != INVALID_INDEX) {
+                slot_index = free_slot_;
+                free_slot_ = slots_[slot_index].index;
+            }
+            else {
+                slot_index = static_cast<std::uint32_t>(slots_.size());
+                slots_.push_back({INVALID_INDEX, 0});
+            }
+
+            auto& slot = slots_[slot_index];
+
+            if (notify_depth_ == 0) {
+                slot.index = static_cast<std::uint32_t>(observers_.size());
+                observers_.emplace_back(std::move(observer));
+                observer_slots_.push_back(slot_index);
+            }
+            else {
+                slot.index = PENDING_FLAG | static_cast<std::uint32_t>(pending_observers_.size());
+                pending_observers_.emplace_back(std::move(observer));
+                pending_slots_.push_back(slot_index);
+            }
+
+            return {this->Handle(), static_cast<SubscriptionId>(slot.generation) << 32 | slot_index};
         }
 
         /**
@@ -80,10 +468,10 @@ namespace core
          *
          * @tparam Candidate Function or member to connect to the delegate.
          *
-         * @return The unique identifier that can be used to unsubscribe.
+         * @return The subscription token.
         */
         template <auto Candidate>
-        std::int32_t Subscribe()
+        [[nodiscard]] Subscription Subscribe()
         {
             return Subscribe({DELEGATE_ARG<Candidate>});
         }
@@ -96,10 +484,10 @@ namespace core
          *
          * @param value_or_instance A valid object that fits the purpose.
          *
-         * @return The unique identifier that can be used to unsubscribe.
+         * @return The subscription token.
         */
         template <auto Candidate, typename Type>
-        std::int32_t Subscribe(const Type* const value_or_instance)
+        [[nodiscard]] Subscription Subscribe(const Type* const value_or_instance)
         {
             return Subscribe({DELEGATE_ARG<Candidate>, value_or_instance});
         }
@@ -110,26 +498,78 @@ namespace core
          * @param function Function to connect to the delegate.
          * @param payload User defined arbitrary data.
          *
-         * @return The unique identifier that can be used to unsubscribe.
+         * @return The subscription token.
         */
-        std::int32_t Subscribe(typename Delegate<void(Args...)>::FunctionType function,
-                               const void* const payload = nullptr)
+        [[nodiscard]] Subscription Subscribe(typename ObserverDelegate::FunctionType function, const void* const payload = nullptr)
         {
-            return Subscribe({function, payload});
+            return Subscribe(ObserverDelegate{function, payload});
         }
 
         /**
          * @brief N/D
          *
-         * @param id The unique identifier.
+         * @note An observer unsubscribed during a notification is not called anymore, even by that notification.
+         *
+         * @param id The unique identifier. Stale identifiers are ignored.
+        */
+        void Unsubscribe(const SubscriptionId id)
+        {
+            const auto slot_index = static_cast<std::uint32_t>(id);
+
+            if (!IsSubscribed(id)) {
+                return;
+            }
+
+            auto& slot = slots_[slot_index];
+            const auto index = slot.index;
+
+            ++slot.generation;
+            slot.index = free_slot_;
+            free_slot_ = slot_index;
+
+            if (index & PENDING_FLAG) {
+                // Subscribed and unsubscribed during the same notification.
+                pending_observers_[index & ~PENDING_FLAG].Reset();
+                pending_slots_[index & ~PENDING_FLAG] = INVALID_INDEX;
+                ++removed_count_;
+            }
+            else if (notify_depth_ == 0) {
+                RemoveObserver(index);
+            }
+            else {
+                // Keep the dense arrays in place while they are iterated, compact them later.
+                // The observer is destroyed by the compaction, it may be the one being called.
+                observer_slots_[index] = INVALID_INDEX;
+                ++removed_count_;
+            }
+        }
+
+        /**
+         * @brief Returns \c true if the identifier refers to an active subscription.
         */
-        void Unsubscribe(const std::int32_t id)
+        [[nodiscard]] bool IsSubscribed(const SubscriptionId id) const noexcept
         {
-            observers_.erase(
-                std::remove_if(observers_.begin(), observers_.end(), [id](const auto& element) {
-                    return element.first == id;
-                }),
-                observers_.end());
+            const auto slot_index = static_cast<std::uint32_t>(id);
+            const auto generation = static_cast<std::uint32_t>(id >> 32);
+
+            if (slot_index >= slots_.size() || slots_[slot_index].generation != generation) {
+                return false;
+            }
+
+            if (const auto index = slots_[slot_index].index; index & PENDING_FLAG) {
+                return (index & ~PENDING_FLAG) < pending_slots_.size() && pending_slots_[index & ~PENDING_FLAG] == slot_index;
+            }
+            else {
+                return index < observers_.size() && observer_slots_[index] == slot_index;
+            }
+        }
+
+        /**
+         * @brief Returns the number of subscribed observers.
+        */
+        [[nodiscard]] std::size_t Size() const noexcept
+        {
+            return observers_.size() + pending_observers_.size() - removed_count_;
         }
 
     protected:
@@ -140,60 +580,376 @@ namespace core
         */
         void Notify(Args&&... args) const
         {
-            for (const auto& observer : observers_) {
-                observer.second(std::forward<Args>(args)...);
+            ++notify_depth_;
+
+            // Observers subscribed during the notification are queued, so the dense arrays
+            // do not change while they are iterated and the observers are called in place.
+            for (std::size_t i = 0, count = observers_.size(); i < count; ++i) {
+                if (observer_slots_[i] != INVALID_INDEX && observers_[i]) {
+                    observers_[i](args...);
+                }
+            }
+
+            if (--notify_depth_ == 0) {
+                ApplyPending();
+            }
+        }
+
+    private:
+        void RemoveObserver(const std::uint32_t index) const
+        {
+            const auto last = static_cast<std::uint32_t>(observers_.size() - 1);
+
+            if (index != last) {
+                observers_[index] = std::move(observers_[last]);
+                observer_slots_[index] = observer_slots_[last];
+
+                if (observer_slots_[index] != INVALID_INDEX) {
+                    slots_[observer_slots_[index]].index = index;
+                }
+            }
+
+            observers_.pop_back();
+            observer_slots_.pop_back();
+        }
+
+        void Compact() const
+        {
+            for (auto index = static_cast<std::uint32_t>(observers_.size()); index-- > 0 && removed_count_ != 0;) {
+                if (observer_slots_[index] == INVALID_INDEX) {
+                    RemoveObserver(index);
+                    --removed_count_;
+                }
+            }
+        }
+
+        void ApplyPending() const
+        {
+            for (std::size_t i = 0; i < pending_observers_.size(); ++i) {
+                if (pending_slots_[i] == INVALID_INDEX) {
+                    --removed_count_;
+                    continue;
+                }
+
+                slots_[pending_slots_[i]].index = static_cast<std::uint32_t>(observers_.size());
+                observers_.emplace_back(std::move(pending_observers_[i]));
+                observer_slots_.push_back(pending_slots_[i]);
+            }
+
+            pending_observers_.clear();
+            pending_slots_.clear();
+
+            if (removed_count_ != 0) {
+                Compact();
             }
         }
     };
 
-    template <typename T>
-    class SubscriptionRaii
+    /**
+     * @brief Result of an event chain subscriber.
+    */
+    enum class EventResult
     {
-        std::shared_ptr<T> observable_{};
-        std::int32_t subscription_id_{};
+        /**
+         * @brief Call the next subscriber.
+        */
+        Continue = 0,
+
+        /**
+         * @brief The event is handled, do not call the next subscribers.
+        */
+        Handled,
+
+        /**
+         * @brief The event is handled, do not call the next subscribers and block the original action.
+        */
+        Supercede
+    };
+
+    template <typename... Args>
+    class EventChain : public detail::SubscriptionSource<EventChain<Args...>>
+    {
+        using ChainFunction = InplaceFunction<EventResult(Args...)>;
+
+        struct Entry
+        {
+            int priority;
+            SubscriptionId id;
+            ChainFunction callback;
+        };
+
+        // Sorted by priority (highest first), then by subscription order.
+        // Dispatch is const, so the storage is mutable to apply the deferred changes after a dispatch.
+        mutable std::vector<Entry> entries_{};
+        mutable std::vector<Entry> pending_entries_{};
+        mutable std::uint32_t dispatch_depth_{};
+        mutable std::uint32_t removed_count_{};
+        SubscriptionId next_id_{1};
 
     public:
         /**
          * @brief Constructor.
         */
-        SubscriptionRaii() = default;
+        EventChain() = default;
 
         /**
-         * @brief Constructor.
+         * @brief Destructor.
+        */
+        virtual ~EventChain() = default;
+
+        /**
+         * @brief Move constructor.
+        */
+        EventChain(EventChain&&) = default;
+
+        /**
+         * @brief Copy constructor.
+        */
+        EventChain(const EventChain&) = default;
+
+        /**
+         * @brief Move assignment operator.
         */
-        SubscriptionRaii(std::shared_ptr<T> observable, const std::int32_t subscription_id)
-            : observable_(std::move(observable)), subscription_id_(subscription_id)
+        EventChain& operator=(EventChain&&) = default;
+
+        /**
+         * @brief Copy assignment operator.
+        */
+        EventChain& operator=(const EventChain&) = default;
+
+        /**
+         * @brief N/D
+         *
+         * @param callback The subscriber: a \c Delegate, or any callable that fits in an \c InplaceFunction.
+         * @param priority Subscribers with a higher priority are called first.
+         * Subscribers with the same priority are called in the order of subscription.
+         *
+         * @note A subscriber added during a dispatch is not called until the next one.
+         *
+         * @return The subscription token; the subscriber is removed when the token is destroyed.
+        */
+        [[nodiscard]] Subscription Subscribe(ChainFunction&& callback, const int priority = 0)
         {
+            const auto id = next_id_++;
+
+            if (dispatch_depth_ == 0) {
+                Insert({priority, id, std::move(callback)});
+            }
+            else {
+                pending_entries_.push_back({priority, id, std::move(callback)});
+            }
+
+            return {this->Handle(), id};
         }
 
         /**
-         * @brief Destructor.
+         * @brief N/D
+         *
+         * @tparam Candidate Function or member to connect to the delegate.
+         *
+         * @param priority Subscribers with a higher priority are called first.
+         *
+         * @return The subscription token.
+        */
+        template <auto Candidate>
+        [[nodiscard]] Subscription Subscribe(const int priority = 0)
+        {
+            return Subscribe({DELEGATE_ARG<Candidate>}, priority);
+        }
+
+        /**
+         * @brief N/D
+         *
+         * @tparam Candidate Function or member to connect to the delegate.
+         * @tparam Type Type of class or type of payload.
+         *
+         * @param value_or_instance A valid object that fits the purpose.
+         * @param priority Subscribers with a higher priority are called first.
+         *
+         * @return The subscription token.
+        */
+        template <auto Candidate, typename Type>
+        [[nodiscard]] Subscription Subscribe(const Type* const value_or_instance, const int priority = 0)
+        {
+            return Subscribe({DELEGATE_ARG<Candidate>, value_or_instance}, priority);
+        }
+
+        /**
+         * @brief N/D
+         *
+         * @note A subscriber removed during a dispatch is not called anymore, even by that dispatch.
+         *
+         * @param id The unique identifier. Unknown identifiers are ignored.
         */
-        ~SubscriptionRaii()
+        void Unsubscribe(const SubscriptionId id)
         {
-            if (observable_) {
-                observable_->Unsubscribe(subscription_id_);
+            if (id == 0) {
+                return;
+            }
+
+            if (const auto it = Find(pending_entries_, id); it != pending_entries_.end()) {
+                pending_entries_.erase(it);
+            }
+            else if (const auto entry = Find(entries_, id); entry != entries_.end()) {
+                if (dispatch_depth_ == 0) {
+                    entries_.erase(entry);
+                }
+                else {
+                    // Keep the array in place while it is iterated, remove the entry later.
+                    // The callback is destroyed with the entry, it may be the one being called.
+                    entry->id = 0;
+                    ++removed_count_;
+                }
             }
         }
 
         /**
-         * @brief Move constructor.
+         * @brief Returns \c true if the identifier refers to an active subscription.
         */
-        SubscriptionRaii(SubscriptionRaii&&) = default;
+        [[nodiscard]] bool IsSubscribed(const SubscriptionId id) const noexcept
+        {
+            return id != 0 && (Find(entries_, id) != entries_.end() || Find(pending_entries_, id) != pending_entries_.end());
+        }
 
         /**
-         * @brief Copy constructor.
+         * @brief Returns the number of subscribers.
         */
-        SubscriptionRaii(const SubscriptionRaii&) = default;
+        [[nodiscard]] std::size_t Size() const noexcept
+        {
+            return entries_.size() - removed_count_ + pending_entries_.size();
+        }
 
+    protected:
         /**
-         * @brief Move assignment operator.
+         * @brief Calls the subscribers in the order of priority until one of them
+         * returns \c EventResult::Handled or \c EventResult::Supercede.
+         *
+         * @param args The callback arguments.
+         *
+         * @return The result of the last called subscriber, or \c EventResult::Continue if there are none.
+        */
+        EventResult Dispatch(Args... args) const
+        {
+            auto result = EventResult::Continue;
+            ++dispatch_depth_;
+
+            // Subscribers added during the dispatch are queued, so the array does not change
+            // while it is iterated and the callbacks are called in place.
+            for (std::size_t i = 0, count = entries_.size(); i < count; ++i) {
+                if (entries_[i].id != 0 && entries_[i].callback) {
+                    if ((result = entries_[i].callback(args...)) != EventResult::Continue) {
+                        break;
+                    }
+                }
+            }
+
+            if (--dispatch_depth_ == 0) {
+                ApplyPendingChanges();
+            }
+
+            return result;
+        }
+
+    private:
+        template <typename Entries>
+        [[nodiscard]] static auto Find(Entries& entries, const SubscriptionId id) noexcept
+        {
+            return std::find_if(entries.begin(), entries.end(), [id](const Entry& entry) {
+                return entry.id == id;
+            });
+        }
+
+        void Insert(Entry&& entry) const
+        {
+            const auto position = std::upper_bound(
+                entries_.begin(), entries_.end(), entry.priority, [](const int priority, const Entry& other) {
+                    return priority > other.priority;
+                });
+
+            entries_.insert(position, std::move(entry));
+        }
+
+        void ApplyPendingChanges() const
+        {
+            if (removed_count_ != 0) {
+                entries_.erase(std::remove_if(entries_.begin(), entries_.end(), [](const Entry& entry) {
+                                   return entry.id == 0;
+                               }),
+                               entries_.end());
+
+                removed_count_ = 0;
+            }
+
+            if (!pending_entries_.empty()) {
+                for (auto& entry : pending_entries_) {
+                    Insert(std::move(entry));
+                }
+
+                pending_entries_.clear();
+            }
+        }
+    };
+
+    /**
+     * @brief Compile-time list of observers.
+     *
+     * Calls the candidates in order with direct (inlinable) calls instead of one indirect call per observer.
+     * Candidates follow the rules of \c Delegate::Connect: free functions and unbound members (the instance
+     * is the first argument) that take all the arguments or only the first ones; return values are ignored.
+     *
+     * @tparam Candidates Functions or members to call.
+    */
+    template <auto... Candidates>
+    class StaticMulticast
+    {
+        template <auto Candidate, std::size_t... Index, typename... Args>
+        FORCEINLINE static void Invoke(std::index_sequence<Index...>, Args&... args)
+        {
+            std::invoke(Candidate, std::get<Index>(std::tie(args...))...);
+        }
+
+        template <auto Candidate, typename... Args>
+        FORCEINLINE static void Call(Args&... args)
+        {
+            using namespace detail;
+
+            if constexpr (std::is_invocable_v<decltype(Candidate), Args&...>) {
+                std::invoke(Candidate, args...);
+            }
+            else if constexpr (std::is_member_pointer_v<decltype(Candidate)>) {
+                Invoke<Candidate>(IndexSequenceFor<TypeListElementType<0, TypeList<Args...>>>(
+                                      FunctionPointerType<decltype(Candidate)>{}),
+                                  args...);
+            }
+            else {
+                Invoke<Candidate>(IndexSequenceFor(FunctionPointerType<decltype(Candidate)>{}), args...);
+            }
+        }
+
+    public:
+        /**
+         * @brief Number of observers.
         */
-        SubscriptionRaii& operator=(SubscriptionRaii&&) = default;
+        static constexpr std::size_t SIZE = sizeof...(Candidates);
 
         /**
-         * @brief Copy assignment operator.
+         * @brief Notify observers.
+         *
+         * @param args The callback arguments (passed as lvalues to every observer).
         */
-        SubscriptionRaii& operator=(const SubscriptionRaii&) = default;
+        template <typename... Args>
+        FORCEINLINE static void Notify(Args&&... args)
+        {
+            (Call<Candidates>(args...), ...);
+        }
+
+        /**
+         * @brief Notify observers.
+        */
+        template <typename... Args>
+        FORCEINLINE void operator()(Args&&... args) const
+        {
+            Notify(args...);
+        }
     };
 }
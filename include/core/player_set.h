@@ -0,0 +1,224 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#if defined(HAS_METAMOD_LIB) && defined(HAS_MHOOKS_LIB)
+#include <cssdk/engine/edict.h>
+#include <cssdk/public/utils.h>
+#include <cassert>
+#include <cstdint>
+
+namespace core
+{
+    /**
+     * @brief Set of player indexes (1 to MAX_CLIENTS) stored as a bitset.
+     * Used as the recipient list of the messages that are sent to a group of players.
+    */
+    class PlayerSet final
+    {
+        static_assert(cssdk::MAX_CLIENTS < 64, "The player bitset does not fit into 64 bits.");
+
+    public:
+        /**
+         * @brief Constructs an empty set.
+        */
+        constexpr PlayerSet() noexcept = default;
+
+        /**
+         * @brief Returns the set of connected players that receive network messages.
+         * Bots are excluded, the engine does not send them any messages.
+        */
+        [[nodiscard]] static PlayerSet Connected();
+
+        /**
+         * @brief Adds the player at the specified index to the set.
+        */
+        constexpr void Add(const int index) noexcept
+        {
+            assert(index > 0 && index <= cssdk::MAX_CLIENTS);
+            bits_ |= Bit(index);
+        }
+
+        /**
+         * @brief Adds the specified player to the set.
+        */
+        void Add(const cssdk::Edict* client);
+
+        /**
+         * @brief Removes the player at the specified index from the set.
+        */
+        constexpr void Remove(const int index) noexcept
+        {
+            assert(index > 0 && index <= cssdk::MAX_CLIENTS);
+            bits_ &= ~Bit(index);
+        }
+
+        /**
+         * @brief Removes the specified player from the set.
+        */
+        void Remove(const cssdk::Edict* client);
+
+        /**
+         * @brief Returns \c true if the player at the specified index is in the set.
+        */
+        [[nodiscard]] constexpr bool Contains(const int index) const noexcept
+        {
+            return index > 0 && index <= cssdk::MAX_CLIENTS && (bits_ & Bit(index)) != 0;
+        }
+
+        /**
+         * @brief Returns \c true if the specified player is in the set.
+        */
+        [[nodiscard]] bool Contains(const cssdk::Edict* client) const;
+
+        /**
+         * @brief Returns \c true if every player of the \c other set is in this set.
+        */
+        [[nodiscard]] constexpr bool Includes(const PlayerSet& other) const noexcept
+        {
+            return (other.bits_ & ~bits_) == 0;
+        }
+
+        /**
+         * @brief Removes all players from the set.
+        */
+        constexpr void Clear() noexcept
+        {
+            bits_ = 0;
+        }
+
+        /**
+         * @brief Returns \c true if the set is empty.
+        */
+        [[nodiscard]] constexpr bool Empty() const noexcept
+        {
+            return bits_ == 0;
+        }
+
+        /**
+         * @brief Returns the number of players in the set.
+        */
+        [[nodiscard]] constexpr int Count() const noexcept
+        {
+            auto count = 0;
+
+            for (auto bits = bits_; bits != 0; bits &= bits - 1) {
+                ++count;
+            }
+
+            return count;
+        }
+
+        /**
+         * @brief Calls \c callback(int index) for each player in the set in ascending index order.
+        */
+        template <typename Callback>
+        void ForEach(Callback&& callback) const
+        {
+            auto bits = bits_;
+
+            for (auto index = 1; bits >> index != 0; ++index) {
+                if (bits & Bit(index)) {
+                    callback(index);
+                }
+            }
+        }
+
+        /**
+         * @brief Adds the players of the \c other set to this set.
+        */
+        constexpr PlayerSet& operator|=(const PlayerSet& other) noexcept
+        {
+            bits_ |= other.bits_;
+            return *this;
+        }
+
+        /**
+         * @brief Keeps only the players that are in both sets.
+        */
+        constexpr PlayerSet& operator&=(const PlayerSet& other) noexcept
+        {
+            bits_ &= other.bits_;
+            return *this;
+        }
+
+        /**
+         * @brief Removes the players of the \c other set from this set.
+        */
+        constexpr PlayerSet& operator-=(const PlayerSet& other) noexcept
+        {
+            bits_ &= ~other.bits_;
+            return *this;
+        }
+
+        /**
+         * @brief Returns the union of two sets.
+        */
+        [[nodiscard]] friend constexpr PlayerSet operator|(PlayerSet lhs, const PlayerSet& rhs) noexcept
+        {
+            return lhs |= rhs;
+        }
+
+        /**
+         * @brief Returns the intersection of two sets.
+        */
+        [[nodiscard]] friend constexpr PlayerSet operator&(PlayerSet lhs, const PlayerSet& rhs) noexcept
+        {
+            return lhs &= rhs;
+        }
+
+        /**
+         * @brief Returns the players of \c lhs that are not in \c rhs.
+        */
+        [[nodiscard]] friend constexpr PlayerSet operator-(PlayerSet lhs, const PlayerSet& rhs) noexcept
+        {
+            return lhs -= rhs;
+        }
+
+        /**
+         * @brief Returns \c true if both sets contain the same players.
+        */
+        [[nodiscard]] friend constexpr bool operator==(const PlayerSet& lhs, const PlayerSet& rhs) noexcept
+        {
+            return lhs.bits_ == rhs.bits_;
+        }
+
+        /**
+         * @brief Returns \c true if the sets contain different players.
+        */
+        [[nodiscard]] friend constexpr bool operator!=(const PlayerSet& lhs, const PlayerSet& rhs) noexcept
+        {
+            return lhs.bits_ != rhs.bits_;
+        }
+
+    private:
+        /**
+         * @brief Returns the bit of the player at the specified index.
+        */
+        [[nodiscard]] static constexpr std::uint64_t Bit(const int index) noexcept
+        {
+            return std::uint64_t{1} << index;
+        }
+
+        /**
+         * @brief Bit \c i is set if the player at index \c i is in the set.
+        */
+        std::uint64_t bits_{};
+    };
+}
+#endif
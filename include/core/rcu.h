@@ -0,0 +1,210 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace core
+{
+    /**
+     * @brief Registers a reader of an \c RcuCell for the duration of its scope.
+    */
+    class RcuReadScope
+    {
+        std::atomic<std::uint32_t>& readers_;
+
+        /**
+         * @brief Increments the reader counter of the current epoch parity and returns it.
+        */
+        static std::atomic<std::uint32_t>& Register(const std::atomic<std::uint32_t>& epoch,
+                                                    std::array<std::atomic<std::uint32_t>, 2>& readers) noexcept
+        {
+            // The writer may advance the epoch and find the counter empty between the load of the epoch
+            // and the increment; such a registration is undone and retried with the new epoch.
+            while (true) {
+                const auto current = epoch.load();
+                auto& counter = readers[current & 1];
+                counter.fetch_add(1);
+
+                if (epoch.load() == current) {
+                    return counter;
+                }
+
+                counter.fetch_sub(1);
+            }
+        }
+
+    public:
+        /**
+         * @brief Constructor.
+        */
+        RcuReadScope(const std::atomic<std::uint32_t>& epoch, std::array<std::atomic<std::uint32_t>, 2>& readers) noexcept
+            : readers_(Register(epoch, readers))
+        {
+        }
+
+        /**
+         * @brief Destructor.
+        */
+        ~RcuReadScope()
+        {
+            readers_.fetch_sub(1);
+        }
+
+        RcuReadScope(const RcuReadScope&) = delete;
+        RcuReadScope(RcuReadScope&&) = delete;
+        RcuReadScope& operator=(const RcuReadScope&) = delete;
+        RcuReadScope& operator=(RcuReadScope&&) = delete;
+    };
+
+    /**
+     * @brief Immutable value published to lock-free readers (read-copy-update).
+     *
+     * Readers pin the cell and load the value without locking. The writer publishes a new value with
+     * an atomic pointer swap; replaced values are freed by \c Reclaim once no reader can see them.
+     *
+     * @note \c Publish, \c Reclaim and \c Current must not be called concurrently (serialize the writers).
+    */
+    template <typename T>
+    class RcuCell
+    {
+        // Readers register in the counter of the current epoch parity; replaced values
+        // are freed once the counter of the previous parity drains.
+        std::atomic<const T*> value_{};
+        mutable std::atomic<std::uint32_t> epoch_{};
+        mutable std::array<std::atomic<std::uint32_t>, 2> readers_{};
+        std::unique_ptr<const T> current_{};
+        std::vector<std::unique_ptr<const T>> retired_{};
+        std::vector<std::unique_ptr<const T>> grace_{};
+
+    public:
+        /**
+         * @brief Constructor.
+        */
+        RcuCell() = default;
+
+        /**
+         * @brief Constructor.
+        */
+        explicit RcuCell(std::unique_ptr<const T> value)
+        {
+            Publish(std::move(value));
+        }
+
+        /**
+         * @brief Destructor.
+        */
+        ~RcuCell() = default;
+
+        /**
+         * @brief Copy constructor.
+        */
+        RcuCell(const RcuCell&) = delete;
+
+        /**
+         * @brief Move constructor.
+        */
+        RcuCell(RcuCell&&) = delete;
+
+        /**
+         * @brief Copy assignment operator.
+        */
+        RcuCell& operator=(const RcuCell&) = delete;
+
+        /**
+         * @brief Move assignment operator.
+        */
+        RcuCell& operator=(RcuCell&&) = delete;
+
+        /**
+         * @brief Keeps the value returned by \c Load valid while the returned scope is alive.
+        */
+        [[nodiscard]] RcuReadScope Pin() const noexcept
+        {
+            return {epoch_, readers_};
+        }
+
+        /**
+         * @brief Returns the published value, or \c nullptr if nothing is published.
+         *
+         * @note Pin the cell before loading; the writer thread can load the value without pinning.
+        */
+        [[nodiscard]] const T* Load() const noexcept
+        {
+            return value_.load();
+        }
+
+        /**
+         * @brief Returns the published value on the writer side.
+        */
+        [[nodiscard]] const T* Current() const noexcept
+        {
+            return current_.get();
+        }
+
+        /**
+         * @brief Publishes the value. Returns \c true if a replaced value is still read;
+         * in this case, \c Reclaim must be called later to free it.
+        */
+        bool Publish(std::unique_ptr<const T> value)
+        {
+            value_.store(value.get());
+
+            if (current_) {
+                retired_.push_back(std::move(current_));
+            }
+
+            current_ = std::move(value);
+            return Reclaim();
+        }
+
+        /**
+         * @brief Frees the replaced values that are no longer read.
+         * Returns \c true if some replaced values are still read.
+        */
+        bool Reclaim()
+        {
+            // A grace period ends when no reader that could have loaded a replaced value is left.
+            if (!grace_.empty()) {
+                if (readers_[(epoch_.load() - 1) & 1].load() != 0) {
+                    return true;
+                }
+
+                grace_.clear();
+            }
+
+            if (retired_.empty()) {
+                return false;
+            }
+
+            grace_.swap(retired_);
+
+            if (const auto epoch = epoch_.fetch_add(1); readers_[epoch & 1].load() == 0) {
+                grace_.clear();
+                return false;
+            }
+
+            return true;
+        }
+    };
+}
@@ -20,7 +20,9 @@
 #include <core/strings/consts.h>
 #include <core/strings/caseconv.h>
 #include <core/strings/compare.h>
+#include <core/strings/cstring_view.h>
 #include <core/strings/examination.h>
+#include <core/strings/fixed_string.h>
 #include <core/strings/format.h>
 #include <core/strings/mutation.h>
 #include <core/strings/path.h>
@@ -0,0 +1,122 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <core/strings/consts.h>
+#include <cassert>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace core::str
+{
+    /**
+     * @brief Non-owning view of a null-terminated string.
+     *
+     * Implicitly constructible from \c const \c char* and \c std::string, so functions that pass
+     * the string to C APIs can accept both without allocating a temporary \c std::string.
+    */
+    class CStringView
+    {
+        const char* string_{EMPTY};
+        std::size_t length_{};
+
+    public:
+        /**
+         * @brief Constructor.
+        */
+        constexpr CStringView() noexcept = default;
+
+        /**
+         * @brief Constructor.
+        */
+        constexpr CStringView(const char* const string) // NOLINT(google-explicit-constructor)
+            : string_(string), length_(std::char_traits<char>::length(string))
+        {
+            assert(string != nullptr);
+        }
+
+        /**
+         * @brief Constructor.
+         *
+         * @note \c string[length] must be a null-terminator character.
+        */
+        constexpr CStringView(const char* const string, const std::size_t length) noexcept
+            : string_(string), length_(length)
+        {
+            assert(string != nullptr);
+        }
+
+        /**
+         * @brief Constructor.
+        */
+        CStringView(const std::string& string) noexcept // NOLINT(google-explicit-constructor)
+            : string_(string.c_str()), length_(string.length())
+        {
+        }
+
+        /**
+         * @brief Returns a pointer to the null-terminated character array.
+        */
+        [[nodiscard]] constexpr const char* c_str() const noexcept
+        {
+            return string_;
+        }
+
+        /**
+         * @brief Returns a pointer to the null-terminated character array.
+        */
+        [[nodiscard]] constexpr const char* data() const noexcept
+        {
+            return string_;
+        }
+
+        /**
+         * @brief Returns the number of characters.
+        */
+        [[nodiscard]] constexpr std::size_t length() const noexcept
+        {
+            return length_;
+        }
+
+        /**
+         * @brief Returns the number of characters.
+        */
+        [[nodiscard]] constexpr std::size_t size() const noexcept
+        {
+            return length_;
+        }
+
+        /**
+         * @brief Returns \c true if the string is empty.
+        */
+        [[nodiscard]] constexpr bool empty() const noexcept
+        {
+            return length_ == 0;
+        }
+
+        /**
+         * @brief Returns a \c string_view of the string.
+        */
+        [[nodiscard]] constexpr operator std::string_view() const noexcept // NOLINT(google-explicit-constructor)
+        {
+            return {string_, length_};
+        }
+    };
+}
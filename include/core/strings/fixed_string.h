@@ -0,0 +1,209 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <core/strings/consts.h>
+#include <core/strings/cstring_view.h>
+#include <core/strings/format.h>
+#include <core/strings/mutation.h>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <utility>
+
+namespace core::str
+{
+    /**
+     * @brief Fixed capacity string stored inline (on the stack).
+     *
+     * Content that exceeds the capacity is truncated without splitting UTF-8 codepoints.
+     *
+     * @tparam N The maximum number of characters (not counting the terminating null character).
+    */
+    template <std::size_t N>
+    class FixedString
+    {
+        static_assert(N > 0, "The capacity must be greater than zero.");
+
+        std::size_t length_{};
+        char data_[N + 1];
+
+    public:
+        /**
+         * @brief Constructor.
+        */
+        FixedString() noexcept
+        {
+            data_[0] = EOS;
+        }
+
+        /**
+         * @brief Constructor.
+        */
+        explicit FixedString(const std::string_view string) noexcept
+        {
+            assign(string);
+        }
+
+        /**
+         * @brief Replaces the contents with a copy of the specified string (truncated if necessary).
+        */
+        FixedString& assign(const std::string_view string) noexcept
+        {
+            const auto truncated = Utf8TruncateView(string, N);
+            length_ = truncated.length();
+            std::memcpy(data_, truncated.data(), length_);
+            data_[length_] = EOS;
+
+            return *this;
+        }
+
+        /**
+         * @brief Sets the length of the string after its buffer was written directly through \c data().
+         *
+         * @param required The number of characters written or required (as returned by \c snprintf).
+         * If it exceeds the capacity, the string is truncated without splitting UTF-8 codepoints.
+        */
+        void commit(const std::size_t required) noexcept
+        {
+            if (required > N) {
+                // The buffer holds N characters followed by the null-terminator.
+                length_ = Utf8TruncatedSize({data_, N + 1}, N);
+            }
+            else {
+                length_ = required;
+            }
+
+            data_[length_] = EOS;
+        }
+
+        /**
+         * @brief Clears the contents.
+        */
+        void clear() noexcept
+        {
+            length_ = 0;
+            data_[0] = EOS;
+        }
+
+        /**
+         * @brief Returns a pointer to the underlying buffer of \c capacity() + 1 characters.
+        */
+        [[nodiscard]] char* data() noexcept
+        {
+            return data_;
+        }
+
+        /**
+         * @brief Returns a pointer to the null-terminated character array.
+        */
+        [[nodiscard]] const char* data() const noexcept
+        {
+            return data_;
+        }
+
+        /**
+         * @brief Returns a pointer to the null-terminated character array.
+        */
+        [[nodiscard]] const char* c_str() const noexcept
+        {
+            return data_;
+        }
+
+        /**
+         * @brief Returns the number of characters.
+        */
+        [[nodiscard]] std::size_t length() const noexcept
+        {
+            return length_;
+        }
+
+        /**
+         * @brief Returns the number of characters.
+        */
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return length_;
+        }
+
+        /**
+         * @brief Returns \c true if the string is empty.
+        */
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return length_ == 0;
+        }
+
+        /**
+         * @brief Returns the maximum number of characters.
+        */
+        [[nodiscard]] static constexpr std::size_t capacity() noexcept
+        {
+            return N;
+        }
+
+        /**
+         * @brief Returns a \c string_view of the string.
+        */
+        [[nodiscard]] operator std::string_view() const noexcept // NOLINT(google-explicit-constructor)
+        {
+            return {data_, length_};
+        }
+
+        /**
+         * @brief Returns a \c CStringView of the string.
+        */
+        [[nodiscard]] operator CStringView() const noexcept // NOLINT(google-explicit-constructor)
+        {
+            return {data_, length_};
+        }
+    };
+
+    /**
+     * @brief Writes a formatted string to the specified fixed string in a single pass.
+     * The result is truncated to the capacity without splitting UTF-8 codepoints.
+     *
+     * @return The length of the resulting string.
+    */
+    template <std::size_t N, typename... Args>
+    std::size_t FormatTo(FixedString<N>& buffer, const CStringView format, Args&&... args)
+    {
+        const auto required = FormatTo(buffer.data(), N + 1, format.c_str(), std::forward<Args>(args)...);
+        buffer.commit(required > 0 ? static_cast<std::size_t>(required) : 0);
+
+        return buffer.length();
+    }
+
+    /**
+     * @brief Writes a formatted string to the specified fixed string using a format string wrapped
+     * with the \c CORE_FORMAT macro. The format string is validated at compile time.
+     *
+     * @return The length of the resulting string.
+    */
+    template <std::size_t N, typename CompiledFormat, typename... Args,
+              std::enable_if_t<detail::IsCompiledFormat<CompiledFormat>(), int> = 0>
+    std::size_t FormatTo(FixedString<N>& buffer, const CompiledFormat format, Args&&... args)
+    {
+        const auto required = FormatTo(buffer.data(), N + 1, format, std::forward<Args>(args)...);
+        buffer.commit(required > 0 ? static_cast<std::size_t>(required) : 0);
+
+        return buffer.length();
+    }
+}
@@ -20,8 +20,12 @@
 #include <core/strings/consts.h>
 #include <core/type_traits.h>
 #include <cssdk/public/os_defs.h>
+#include <cassert>
+#include <cstddef>
 #include <cstdio>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 
 #if defined(CLANG_COMPILER) || (defined(_MSC_VER) && defined(__clang__)) || defined(INTEL_LLVM_COMPILER)
@@ -34,6 +38,11 @@
 
 namespace core::str
 {
+    /**
+     * @brief Size of the stack buffer used by \c Format before falling back to a heap allocation.
+    */
+    constexpr std::size_t FORMAT_INLINE_BUFFER_SIZE = 512;
+
     namespace detail
     {
         template <typename T>
@@ -51,38 +60,311 @@ namespace core::str
                 return std::forward<T>(v);
             }
         }
+
+        /**
+         * @brief Category of a value passed to the formatter after \c Cast is applied.
+        */
+        enum class FormatArgKind
+        {
+            None,
+            Integer,
+            Floating,
+            String,
+            Pointer
+        };
+
+        template <typename T>
+        constexpr FormatArgKind GetFormatArgKind()
+        {
+            using Type = std::decay_t<decltype(Cast(std::declval<T>()))>;
+
+            if constexpr (std::is_integral_v<Type> || std::is_enum_v<Type>) {
+                return FormatArgKind::Integer;
+            }
+            else if constexpr (std::is_floating_point_v<Type>) {
+                return FormatArgKind::Floating;
+            }
+            else if constexpr (std::is_same_v<Type, const char*> || std::is_same_v<Type, char*>) {
+                return FormatArgKind::String;
+            }
+            else if constexpr (std::is_pointer_v<Type> || std::is_null_pointer_v<Type>) {
+                return FormatArgKind::Pointer;
+            }
+            else {
+                return FormatArgKind::None;
+            }
+        }
+
+        /**
+         * @brief Returns the argument kind expected by the specified conversion specifier.
+        */
+        constexpr FormatArgKind GetConversionArgKind(const char conversion)
+        {
+            switch (conversion) {
+            case 'c':
+            case 'd':
+            case 'i':
+            case 'o':
+            case 'u':
+            case 'x':
+            case 'X':
+                return FormatArgKind::Integer;
+
+            case 'a':
+            case 'A':
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+                return FormatArgKind::Floating;
+
+            case 's':
+                return FormatArgKind::String;
+
+            case 'n':
+            case 'p':
+                return FormatArgKind::Pointer;
+
+            default:
+                return FormatArgKind::None;
+            }
+        }
+
+        constexpr bool IsFormatFlag(const char ch)
+        {
+            return ch == '-' || ch == '+' || ch == ' ' || ch == '#' || ch == '0';
+        }
+
+        constexpr bool IsFormatDigit(const char ch)
+        {
+            return ch >= '0' && ch <= '9';
+        }
+
+        constexpr bool IsFormatLengthModifier(const char ch)
+        {
+            return ch == 'h' || ch == 'l' || ch == 'j' || ch == 'z' || ch == 't' || ch == 'L';
+        }
+
+        /**
+         * @brief Parses the format string and checks each conversion specifier against the argument kinds.
+        */
+        constexpr bool ValidateFormat(const std::string_view format, const FormatArgKind* const kinds,
+                                      const std::size_t count)
+        {
+            std::size_t arg{};
+            std::size_t pos{};
+
+            const auto consume = [&](const FormatArgKind kind) {
+                if (arg >= count || (kinds[arg] != kind && !(kind == FormatArgKind::Pointer &&
+                                                             kinds[arg] == FormatArgKind::String))) {
+                    return false;
+                }
+
+                ++arg;
+                return true;
+            };
+
+            while (pos < format.length()) {
+                if (format[pos++] != '%') {
+                    continue;
+                }
+
+                if (pos < format.length() && format[pos] == '%') {
+                    ++pos;
+                    continue;
+                }
+
+                while (pos < format.length() && IsFormatFlag(format[pos])) {
+                    ++pos;
+                }
+
+                if (pos < format.length() && format[pos] == '*') {
+                    if (!consume(FormatArgKind::Integer)) {
+                        return false;
+                    }
+
+                    ++pos;
+                }
+                else {
+                    while (pos < format.length() && IsFormatDigit(format[pos])) {
+                        ++pos;
+                    }
+                }
+
+                if (pos < format.length() && format[pos] == '.') {
+                    if (++pos < format.length() && format[pos] == '*') {
+                        if (!consume(FormatArgKind::Integer)) {
+                            return false;
+                        }
+
+                        ++pos;
+                    }
+                    else {
+                        while (pos < format.length() && IsFormatDigit(format[pos])) {
+                            ++pos;
+                        }
+                    }
+                }
+
+                while (pos < format.length() && IsFormatLengthModifier(format[pos])) {
+                    ++pos;
+                }
+
+                if (pos >= format.length()) {
+                    return false;
+                }
+
+                if (const auto kind = GetConversionArgKind(format[pos++]); kind == FormatArgKind::None || !consume(kind)) {
+                    return false;
+                }
+            }
+
+            return arg == count;
+        }
+
+        /**
+         * @brief Base class of the types produced by the \c CORE_FORMAT macro.
+        */
+        struct CompiledFormat
+        {
+        };
+
+        template <typename T>
+        constexpr bool IsCompiledFormat()
+        {
+            return std::is_base_of_v<CompiledFormat, std::decay_t<T>>;
+        }
+    }
+
+    /**
+     * @brief Returns \c true if the conversion specifiers of the format string match the specified argument types.
+     *
+     * @note Can be evaluated at compile time.
+    */
+    template <typename... Args>
+    [[nodiscard]] constexpr bool IsValidFormat(const std::string_view format)
+    {
+        constexpr detail::FormatArgKind kinds[] = {detail::GetFormatArgKind<Args>()..., detail::FormatArgKind::None};
+        return detail::ValidateFormat(format, kinds, sizeof...(Args));
+    }
+
+    /**
+     * @brief Writes a formatted string to the specified buffer in a single pass.
+     *
+     * @return The number of characters that would have been written if the buffer had been large enough
+     * (not counting the terminating null character), or a negative value on encoding error.
+    */
+    template <typename... Args>
+    int FormatTo(char* const buffer, const std::size_t size, const char* const format, Args&&... args)
+    {
+        assert(buffer != nullptr || size == 0);
+        assert(format != nullptr);
+
+        // NOLINTNEXTLINE(clang-diagnostic-format-nonliteral, clang-diagnostic-format-security)
+        return std::snprintf(buffer, size, format, detail::Cast(std::forward<Args>(args))...);
+    }
+
+    /**
+     * @brief Writes a formatted string to the specified buffer in a single pass.
+     *
+     * @return The number of characters that would have been written if the buffer had been large enough
+     * (not counting the terminating null character), or a negative value on encoding error.
+    */
+    template <std::size_t N, typename... Args>
+    int FormatTo(char (&buffer)[N], const char* const format, Args&&... args)
+    {
+        return FormatTo(buffer, N, format, std::forward<Args>(args)...);
     }
 
     /**
      * @brief Returns a formatted string (alternative to \c snprintf with a \c string support).
      *
+     * The result is written to a stack buffer first; the string is formatted a second time
+     * only if it does not fit into \c FORMAT_INLINE_BUFFER_SIZE characters.
+     *
      * @note See https://en.cppreference.com/w/cpp/io/c/fprintf for more details.
     */
     template <typename... Args>
-    [[nodiscard]] std::string Format(const std::string& format, Args&&... args)
+    [[nodiscard]] std::string Format(const char* const format, Args&&... args)
     {
-        std::string string{EMPTY};
+        char buffer[FORMAT_INLINE_BUFFER_SIZE];
+        const auto required = FormatTo(buffer, format, args...);
 
-        // NOLINTNEXTLINE(clang-diagnostic-format-nonliteral, clang-diagnostic-format-security)
-        const auto required = std::snprintf(nullptr, 0, format.c_str(), detail::Cast(std::forward<Args>(args))...); // cppcheck-suppress accessForwarded
+        if (required <= 0) {
+            return std::string{};
+        }
 
-        if (required > 0) {
-            string.resize(static_cast<std::string::size_type>(required), EOS);
+        const auto length = static_cast<std::string::size_type>(required);
 
-#ifdef _MSC_VER
-#pragma warning(disable : 26800)
-#endif
-            // NOLINTNEXTLINE(clang-diagnostic-format-nonliteral, clang-diagnostic-format-security)
-            std::snprintf(string.data(), required + 1, format.c_str(), detail::Cast(std::forward<Args>(args))...); // cppcheck-suppress accessForwarded
-#ifdef _MSC_VER
-#pragma warning(default : 26800)
-#endif
+        if (length < sizeof buffer) {
+            return std::string(buffer, length);
         }
 
+        std::string string(length, EOS);
+        FormatTo(string.data(), length + 1, format, std::forward<Args>(args)...);
+
         return string;
     }
+
+    /**
+     * @brief Returns a formatted string (alternative to \c snprintf with a \c string support).
+     *
+     * @note See https://en.cppreference.com/w/cpp/io/c/fprintf for more details.
+    */
+    template <typename... Args>
+    [[nodiscard]] std::string Format(const std::string& format, Args&&... args)
+    {
+        return Format(format.c_str(), std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Returns a formatted string using a format string wrapped with the \c CORE_FORMAT macro.
+     *
+     * The format string is parsed and validated against the argument types at compile time.
+    */
+    template <typename CompiledFormat, typename... Args,
+              std::enable_if_t<detail::IsCompiledFormat<CompiledFormat>(), int> = 0>
+    [[nodiscard]] std::string Format(CompiledFormat, Args&&... args)
+    {
+        static_assert(IsValidFormat<Args...>(CompiledFormat::Value()),
+                      "The format string does not match the provided arguments.");
+
+        return Format(CompiledFormat::Value().data(), std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Writes a formatted string to the specified buffer using a format string wrapped
+     * with the \c CORE_FORMAT macro. The format string is validated at compile time.
+    */
+    template <typename CompiledFormat, typename... Args,
+              std::enable_if_t<detail::IsCompiledFormat<CompiledFormat>(), int> = 0>
+    int FormatTo(char* const buffer, const std::size_t size, CompiledFormat, Args&&... args)
+    {
+        static_assert(IsValidFormat<Args...>(CompiledFormat::Value()),
+                      "The format string does not match the provided arguments.");
+
+        return FormatTo(buffer, size, CompiledFormat::Value().data(), std::forward<Args>(args)...);
+    }
 }
 
+/**
+ * @brief Wraps a format string literal so that \c core::str::Format can parse
+ * and validate it against the argument types at compile time.
+*/
+#define CORE_FORMAT(format)                                                \
+    [] {                                                                   \
+        struct CompiledFormat final : core::str::detail::CompiledFormat    \
+        {                                                                  \
+            static constexpr std::string_view Value()                      \
+            {                                                              \
+                return format;                                             \
+            }                                                              \
+        };                                                                 \
+        return CompiledFormat{};                                           \
+    }()
+
 #if defined(CLANG_COMPILER) || (defined(_MSC_VER) && defined(__clang__)) || defined(INTEL_LLVM_COMPILER)
 #pragma clang diagnostic pop
 #elif defined(GCC_COMPILER)
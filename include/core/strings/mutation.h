@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cctype>
+#include <cstddef>
 #include <string>
 #include <string_view>
 
@@ -31,6 +32,39 @@ namespace core::str
     */
     [[nodiscard]] std::string Utf8Truncate(const std::string& string, std::string_view::size_type max_size);
 
+    /**
+     * @brief Returns the size of the longest prefix of the UTF-8 string that does not exceed the specified size
+     * and does not end with a partial codepoint.
+    */
+    [[nodiscard]] std::size_t Utf8TruncatedSize(std::string_view string, std::size_t max_size);
+
+    /**
+     * @brief Returns a view of the UTF-8 string truncated to the specified size (without copying).
+     *
+     * @note The returned view is not null-terminated if the string was truncated.
+    */
+    [[nodiscard]] inline std::string_view Utf8TruncateView(const std::string_view string,
+                                                           const std::string_view::size_type max_size)
+    {
+        return string.substr(0, Utf8TruncatedSize(string, max_size));
+    }
+
+    /**
+     * @brief Truncates the UTF-8 string in place to the specified size.
+    */
+    inline void Utf8TruncateInPlace(std::string& string, const std::string::size_type max_size)
+    {
+        string.resize(Utf8TruncatedSize(string, max_size));
+    }
+
+    /**
+     * @brief Truncates a null-terminated UTF-8 string in place so that it does not exceed the specified size
+     * and does not end with a partial codepoint.
+     *
+     * @return The new length of the string.
+    */
+    std::size_t Utf8TruncateInPlace(char* string, std::size_t length, std::size_t max_size);
+
     /**
      * @brief Replaces all occurrences of a specified character in the specified string with another specified character.
     */
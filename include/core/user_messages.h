@@ -0,0 +1,249 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifdef HAS_METAMOD_LIB
+#include <cssdk/engine/edict.h>
+#include <cssdk/engine/eiface.h>
+#include <metamod/engine.h>
+#include <array>
+#include <cstddef>
+
+namespace core::messages
+{
+    /**
+     * @brief User messages used by the library.
+    */
+    enum class UserMsg
+    {
+        /**
+         * @brief TextMsg message.
+        */
+        TextMsg,
+
+        /**
+         * @brief SayText message.
+        */
+        SayText,
+
+        /**
+         * @brief ShowMenu message.
+        */
+        ShowMenu,
+
+        /**
+         * @brief Number of the user messages.
+        */
+        Count
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief IDs of the user messages indexed by \c UserMsg.
+         * 0 if the message is not resolved yet, -1 if the game does not register it.
+        */
+        inline std::array<int, static_cast<std::size_t>(UserMsg::Count)> user_msg_ids{};
+
+        /**
+         * @brief Resolves the ID of the specified user message (slow path of \c UserMsgId).
+        */
+        int ResolveUserMsgId(UserMsg message);
+    }
+
+    /**
+     * @brief Resolves the IDs of all user messages in one pass.
+     * If the mhooks library is available, they are resolved again at the beginning of each ServerActivate,
+     * so the IDs are valid for the current map. The hook is installed on the first call to this function
+     * or on the first unresolved \c UserMsgId.
+    */
+    void ResolveUserMessages();
+
+    /**
+     * @brief Returns the name of the specified user message.
+    */
+    [[nodiscard]] const char* UserMsgName(UserMsg message);
+
+    /**
+     * @brief Returns the ID of the specified user message, or 0 if the game does not register it.
+    */
+    [[nodiscard]] inline int UserMsgId(const UserMsg message)
+    {
+        if (const auto id = detail::user_msg_ids[static_cast<std::size_t>(message)]; id != 0) {
+            return id > 0 ? id : 0;
+        }
+
+        return detail::ResolveUserMsgId(message);
+    }
+
+    /**
+     * @brief Fields of the user message schemas.
+     * Each field writes its value with the metamod engine functions, or with the specified engine functions table.
+    */
+    namespace field
+    {
+        /**
+         * @brief Unsigned 8-bit field.
+        */
+        struct Byte
+        {
+            using Type = int;
+
+            static void Write(const Type value)
+            {
+                metamod::engine::WriteByte(value);
+            }
+
+            static void Write(const cssdk::EngineFunctions& funcs, const Type value)
+            {
+                funcs.write_byte(value);
+            }
+        };
+
+        /**
+         * @brief Signed 8-bit field.
+        */
+        struct Char
+        {
+            using Type = int;
+
+            static void Write(const Type value)
+            {
+                metamod::engine::WriteChar(value);
+            }
+
+            static void Write(const cssdk::EngineFunctions& funcs, const Type value)
+            {
+                funcs.write_char(value);
+            }
+        };
+
+        /**
+         * @brief Signed 16-bit field.
+        */
+        struct Short
+        {
+            using Type = int;
+
+            static void Write(const Type value)
+            {
+                metamod::engine::WriteShort(value);
+            }
+
+            static void Write(const cssdk::EngineFunctions& funcs, const Type value)
+            {
+                funcs.write_short(value);
+            }
+        };
+
+        /**
+         * @brief Null-terminated string field.
+        */
+        struct String
+        {
+            using Type = const char*;
+
+            static void Write(const Type value)
+            {
+                metamod::engine::WriteString(value);
+            }
+
+            static void Write(const cssdk::EngineFunctions& funcs, const Type value)
+            {
+                funcs.write_string(value);
+            }
+        };
+    }
+
+    /**
+     * @brief Compile-time schema of a user message: its registry entry and the sequence of its fields.
+     * Sending the message is a fixed sequence of write calls, the only lookup is the ID array load.
+    */
+    template <UserMsg Message, typename... Fields>
+    struct UserMessage
+    {
+        /**
+         * @brief Registry entry of the message.
+        */
+        static constexpr auto MESSAGE = Message;
+
+        /**
+         * @brief Sends the message with the metamod engine functions (visible to the other plugins hooks).
+         *
+         * @return \c false if the game does not register the message.
+        */
+        static bool Send(const cssdk::MessageType type, cssdk::Edict* const client,
+                         const typename Fields::Type... values)
+        {
+            const auto id = UserMsgId(Message);
+
+            if (!id) {
+                return false;
+            }
+
+            metamod::engine::MessageBegin(type, id, nullptr, client);
+            (Fields::Write(values), ...);
+            metamod::engine::MessageEnd();
+
+            return true;
+        }
+
+        /**
+         * @brief Sends the message with the specified engine functions table.
+         *
+         * @return \c false if the game does not register the message.
+        */
+        static bool Send(const cssdk::EngineFunctions& funcs, const cssdk::MessageType type,
+                         cssdk::Edict* const client, const typename Fields::Type... values)
+        {
+            const auto id = UserMsgId(Message);
+
+            if (!id) {
+                return false;
+            }
+
+            funcs.message_begin(type, id, nullptr, client);
+            (Fields::Write(funcs, values), ...);
+            funcs.message_end();
+
+            return true;
+        }
+    };
+
+    /**
+     * @brief User message schemas.
+    */
+    namespace schema
+    {
+        /**
+         * @brief TextMsg: destination, text.
+        */
+        using TextMsg = UserMessage<UserMsg::TextMsg, field::Byte, field::String>;
+
+        /**
+         * @brief SayText: sender, text.
+        */
+        using SayText = UserMessage<UserMsg::SayText, field::Byte, field::String>;
+
+        /**
+         * @brief ShowMenu: keys, display time, more chunks flag, text chunk.
+        */
+        using ShowMenu = UserMessage<UserMsg::ShowMenu, field::Short, field::Char, field::Byte, field::String>;
+    }
+}
+#endif
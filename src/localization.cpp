@@ -18,53 +18,153 @@
 #ifdef HAS_METAMOD_LIB
 #include <core/localization.h>
 #include <core/console.h>
+#include <cssdk/common/cvar.h>
 #include <cssdk/public/os_defs.h>
 #include <cssdk/public/utils.h>
 #include <metamod/engine.h>
 #include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
 #include <cstdio>
-#include <functional>
+#include <cstring>
+#include <future>
+#include <unordered_map>
+#include <vector>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef HAS_MHOOKS_LIB
+#include <core/type_conversion.h>
+#include <mhooks/metamod.h>
+#endif
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN // NOLINT(clang-diagnostic-unused-macros)
+#include <Windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 using namespace core;
+using namespace core::detail;
 using namespace cssdk;
 using namespace metamod;
 
+#ifdef HAS_MHOOKS_LIB
+using namespace mhooks;
+#endif
+
 namespace
 {
-    bool IsLangInList(const std::vector<std::string>& languages, const std::string_view lang)
+    constexpr std::uint32_t IMAGE_MAGIC = 0x434F4C43; // "CLOC"
+    constexpr std::uint32_t IMAGE_VERSION = 1;
+
+    // The amx_language CVar, looked up once. Its value is read directly, so changes are seen immediately.
+    const CVar* g_amx_language{};
+
+#ifdef HAS_MHOOKS_LIB
+    struct PlayerLanguage
+    {
+        bool cached{};
+        std::size_t length{};
+        std::array<char, 16> code{};
+    };
+
+    // Cached "lang" userinfo values indexed by the client index.
+    std::array<PlayerLanguage, MAX_CLIENTS + 1> g_player_languages{};
+
+    void InvalidatePlayerLanguage(const Edict* const client)
     {
-        return std::any_of(languages.cbegin(), languages.cend(), [lang](const auto& element) {
-            return str::Equals(element, lang);
-        });
+        if (IsValidEntity(client)) {
+            if (const auto index = type_conversion::IndexOfEntity(client); IsClient(index)) {
+                g_player_languages[index].cached = false;
+            }
+        }
     }
 
-    std::string_view GetLanguage(Edict* const client, const std::string& language)
+    qboolean OnClientConnect(const GameDllClientConnectMChain& chain, Edict* const client,
+                             const char* const name, const char* const address, char* const reject_reason)
     {
-        const auto* const amx_language =
-            g_engine_funcs.cvar_get_string ? engine::CvarGetString("amx_language") : nullptr;
+        InvalidatePlayerLanguage(client);
+        return chain.CallNext(client, name, address, reject_reason);
+    }
 
-#ifdef MSVC_COMPILER
-#pragma warning(push)
-#pragma warning(disable : 6387)
+    void OnClientUserInfoChanged(const GameDllClientUserInfoChangedMChain& chain, Edict* const client,
+                                 char* const info_buffer)
+    {
+        InvalidatePlayerLanguage(client);
+        chain.CallNext(client, info_buffer);
+    }
+
+    void InitLanguageCache()
+    {
+        static auto initialized = false;
+
+        if (initialized) {
+            return;
+        }
+
+        initialized = true;
+        type_conversion::Init();
+        MHookGameDllClientConnect(DELEGATE_ARG<OnClientConnect>, false, HookChainPriority::Uninterruptable);
+        MHookGameDllClientUserInfoChanged(DELEGATE_ARG<OnClientUserInfoChanged>, false, HookChainPriority::Uninterruptable);
+    }
 #endif
-        const std::string_view server_language = !str::IsNullOrEmpty(amx_language) ? amx_language : "en";
-#ifdef MSVC_COMPILER
-#pragma warning(pop)
+
+    std::string_view GetServerLanguage()
+    {
+        if (!g_amx_language && g_engine_funcs.cvar_get_pointer) {
+            g_amx_language = engine::CvarGetPointer("amx_language");
+        }
+
+        const auto* const amx_language = g_amx_language ? g_amx_language->string : nullptr;
+        return !str::IsNullOrEmpty(amx_language) ? std::string_view{amx_language} : std::string_view{"en"};
+    }
+
+    std::string_view GetPlayerLanguage(Edict* const client)
+    {
+#ifdef HAS_MHOOKS_LIB
+        if (const auto index = type_conversion::IndexOfEntity(client); IsClient(index)) {
+            auto& language = g_player_languages[index];
+
+            if (!language.cached) {
+                const auto* const player_lang = EntityKeyValue(client, "lang");
+                language.length = 0;
+
+                if (!str::IsNullOrEmpty(player_lang)) {
+                    language.length = std::min(std::strlen(player_lang), language.code.size() - 1);
+                    std::memcpy(language.code.data(), player_lang, language.length);
+                }
+
+                language.cached = true;
+            }
+
+            return {language.code.data(), language.length};
+        }
 #endif
+        const auto* const player_lang = EntityKeyValue(client, "lang");
+        return !str::IsNullOrEmpty(player_lang) ? std::string_view{player_lang} : std::string_view{};
+    }
 
+    std::string_view GetLanguage(Edict* const client, const std::string& language)
+    {
         if (client && str::IEquals(language, "player")) {
-            const auto* const player_lang = EntityKeyValue(client, "lang");
-            return !str::IsNullOrEmpty(player_lang) ? std::string_view{player_lang} : server_language;
+            const auto player_lang = GetPlayerLanguage(client);
+            return !player_lang.empty() ? player_lang : GetServerLanguage();
         }
 
         if (str::IEquals(language, "server")) {
-            return server_language;
+            return GetServerLanguage();
         }
 
         return language;
     }
 
-    bool SplitLabelText(const std::string_view string, std::string_view& label, std::string& text)
+    bool SplitLabelText(const std::string_view string, std::string_view& label, std::string_view& text)
     {
         const auto label_end = string.find_first_of('=');
 
@@ -72,104 +172,918 @@ namespace
             return false;
         }
 
-        label = string.substr(0, label_end);
-        label = str::Trim(label);
-
-        text = string.substr(label_end + 1);
-        text = str::Trim(text);
+        label = str::Trim(string.substr(0, label_end));
+        text = str::Trim(string.substr(label_end + 1));
 
         return !label.empty();
     }
 
-    void Parse(const std::string& filepath, std::vector<std::string>& languages,
-               std::unordered_map<std::size_t, std::string>& localization)
+    template <typename T>
+    constexpr std::uint32_t AlignImageOffset(const std::size_t offset)
+    {
+        return static_cast<std::uint32_t>((offset + alignof(T) - 1) & ~(alignof(T) - 1));
+    }
+
+    /**
+     * @brief Collects the parsed texts and compiles them into a localization image.
+    */
+    class TableBuilder
     {
+        struct Entry
+        {
+            std::uint32_t language;
+            std::uint32_t label;
+            std::uint32_t offset;
+            std::uint32_t length;
+        };
+
+        std::vector<LocalizationImageLanguage> languages_{};
+        std::vector<LocalizationImageLabel> labels_{};
+        std::unordered_map<std::string, std::uint32_t> label_ids_{};
+        std::vector<Entry> entries_{};
+        std::string arena_{};
+
+    public:
+        /**
+         * @brief Returns the index of the language, adding it if necessary.
+        */
+        std::uint32_t AddLanguage(const std::string_view code)
+        {
+            assert(!code.empty() && code.length() < sizeof(LocalizationImageLanguage::code));
+
+            for (std::uint32_t i = 0; i < languages_.size(); ++i) {
+                if (str::Equals(languages_[i].code, code)) {
+                    return i;
+                }
+            }
+
+            auto& language = languages_.emplace_back();
+            std::memset(language.code, 0, sizeof language.code);
+            std::memcpy(language.code, code.data(), code.length());
+
+            return static_cast<std::uint32_t>(languages_.size() - 1);
+        }
+
+        /**
+         * @brief Adds the text of the label in the language (replaces the previous one, if any).
+         * The color codes (^1, ^3 and ^4) are decoded while the text is copied to the arena.
+        */
+        void AddText(const std::uint32_t language, const std::string_view label, const std::string_view text)
+        {
+            const auto label_id = AddLabel(label);
+            const auto offset = static_cast<std::uint32_t>(arena_.size());
+
+            AppendDecodedText(text);
+            const auto length = static_cast<std::uint32_t>(arena_.size() - offset);
+            arena_.push_back(str::EOS);
+
+            entries_.push_back({language, label_id, offset, length});
+        }
+
+        /**
+         * @brief Reserves the arena for the specified amount of source text.
+        */
+        void Reserve(const std::size_t size)
+        {
+            arena_.reserve(arena_.size() + size);
+        }
+
+        /**
+         * @brief Returns \c true if no text was added.
+        */
+        [[nodiscard]] bool Empty() const noexcept
+        {
+            return entries_.empty();
+        }
+
+        /**
+         * @brief Compiles the collected texts into a localization image.
+        */
+        [[nodiscard]] std::shared_ptr<const void> Build(const std::uint64_t fingerprint) const
+        {
+            const auto language_count = static_cast<std::uint32_t>(languages_.size());
+            const auto label_count = static_cast<std::uint32_t>(labels_.size());
+
+            std::uint32_t slot_count = 1;
+            while (slot_count < label_count * 2) {
+                slot_count <<= 1;
+            }
+
+            LocalizationImageHeader header{};
+            header.magic = IMAGE_MAGIC;
+            header.version = IMAGE_VERSION;
+            header.fingerprint = fingerprint;
+            header.language_count = language_count;
+            header.label_count = label_count;
+            header.slot_count = slot_count;
+            header.languages_offset = AlignImageOffset<LocalizationImageLanguage>(sizeof header);
+            header.labels_offset = AlignImageOffset<LocalizationImageLabel>(
+                header.languages_offset + sizeof(LocalizationImageLanguage) * language_count);
+            header.slots_offset = AlignImageOffset<std::uint32_t>(
+                header.labels_offset + sizeof(LocalizationImageLabel) * label_count);
+            header.texts_offset = AlignImageOffset<LocalizationImageText>(
+                header.slots_offset + sizeof(std::uint32_t) * slot_count);
+            header.arena_offset = static_cast<std::uint32_t>(
+                header.texts_offset + sizeof(LocalizationImageText) * language_count * label_count);
+            header.arena_size = static_cast<std::uint32_t>(arena_.size());
+            header.image_size = header.arena_offset + header.arena_size;
+
+            auto buffer = std::make_shared<std::vector<std::uint64_t>>(
+                (header.image_size + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t));
+            auto* const image = reinterpret_cast<std::byte*>(buffer->data());
+
+            std::memcpy(image, &header, sizeof header);
+            std::memcpy(image + header.languages_offset, languages_.data(),
+                        sizeof(LocalizationImageLanguage) * language_count);
+            std::memcpy(image + header.labels_offset, labels_.data(), sizeof(LocalizationImageLabel) * label_count);
+            std::memcpy(image + header.arena_offset, arena_.data(), arena_.size());
+
+            auto* const slots = reinterpret_cast<std::uint32_t*>(image + header.slots_offset);
+            std::fill_n(slots, slot_count, 0);
+
+            for (std::uint32_t label_id = 0; label_id < label_count; ++label_id) {
+                auto slot = static_cast<std::uint32_t>(labels_[label_id].hash) & (slot_count - 1);
+
+                while (slots[slot] != 0) {
+                    slot = (slot + 1) & (slot_count - 1);
+                }
+
+                slots[slot] = label_id + 1;
+            }
+
+            auto* const texts = reinterpret_cast<LocalizationImageText*>(image + header.texts_offset);
+            std::fill_n(texts, static_cast<std::size_t>(language_count) * label_count,
+                        LocalizationImageText{LocalizationTable::NPOS, 0});
+
+            for (const auto& entry : entries_) {
+                texts[static_cast<std::size_t>(entry.language) * label_count + entry.label] = {entry.offset, entry.length};
+            }
+
+            return {buffer, buffer->data()};
+        }
+
+    private:
+        std::uint32_t AddLabel(const std::string_view label)
+        {
+            const auto [it, inserted] =
+                label_ids_.try_emplace(std::string{label}, static_cast<std::uint32_t>(labels_.size()));
+
+            if (inserted) {
+                const auto offset = AppendToArena(label);
+                labels_.push_back({HashLabel(label), offset, static_cast<std::uint32_t>(label.length())});
+            }
+
+            return it->second;
+        }
+
+        void AppendDecodedText(std::string_view text)
+        {
+            for (auto pos = text.find('^'); pos != std::string_view::npos; pos = text.find('^')) {
+                arena_.append(text.data(), pos);
+
+                if (const auto code = pos + 1 < text.length() ? text[pos + 1] : str::EOS;
+                    code == '1' || code == '3' || code == '4') {
+                    arena_.push_back(static_cast<char>(code - '0'));
+                    text.remove_prefix(pos + 2);
+                }
+                else {
+                    arena_.push_back('^');
+                    text.remove_prefix(pos + 1);
+                }
+            }
+
+            arena_.append(text);
+        }
+
+        std::uint32_t AppendToArena(const std::string_view string)
+        {
+            const auto offset = static_cast<std::uint32_t>(arena_.size());
+
+            arena_.append(string);
+            arena_.push_back(str::EOS);
+
+            return offset;
+        }
+    };
+
+    /**
+     * @brief Checks that all offsets of the localization image are within its bounds.
+    */
+    bool ValidateImage(const std::byte* const image, const std::size_t size, const std::uint64_t fingerprint)
+    {
+        if (size < sizeof(LocalizationImageHeader)) {
+            return false;
+        }
+
+        LocalizationImageHeader header{};
+        std::memcpy(&header, image, sizeof header);
+
+        if (header.magic != IMAGE_MAGIC || header.version != IMAGE_VERSION || header.fingerprint != fingerprint ||
+            header.image_size != size || header.language_count == 0 || header.slot_count == 0 ||
+            (header.slot_count & (header.slot_count - 1)) != 0 || header.slot_count <= header.label_count) {
+            return false;
+        }
+
+        // Counts are compared with the space left instead of being multiplied, so that nothing overflows
+        // the 32-bit std::size_t.
+        const auto section_fits = [size](const std::uint32_t offset, const std::uint64_t count, const std::size_t element_size, const std::size_t align) {
+            return offset % align == 0 && offset <= size && count <= (size - offset) / element_size;
+        };
+
+        const auto text_count = static_cast<std::uint64_t>(header.language_count) * header.label_count;
+
+        if (!section_fits(header.languages_offset, header.language_count, sizeof(LocalizationImageLanguage), alignof(LocalizationImageLanguage)) ||
+            !section_fits(header.labels_offset, header.label_count, sizeof(LocalizationImageLabel), alignof(LocalizationImageLabel)) ||
+            !section_fits(header.slots_offset, header.slot_count, sizeof(std::uint32_t), alignof(std::uint32_t)) ||
+            !section_fits(header.texts_offset, text_count, sizeof(LocalizationImageText), alignof(LocalizationImageText)) ||
+            !section_fits(header.arena_offset, header.arena_size, 1, 1)) {
+            return false;
+        }
+
+        const auto* const arena = reinterpret_cast<const char*>(image + header.arena_offset);
+
+        const auto string_fits = [&header, arena](const std::uint32_t offset, const std::uint32_t length) {
+            return offset < header.arena_size && length < header.arena_size - offset && arena[offset + length] == str::EOS;
+        };
+
+        const auto* const languages = reinterpret_cast<const LocalizationImageLanguage*>(image + header.languages_offset);
+
+        for (std::uint32_t i = 0; i < header.language_count; ++i) {
+            if (languages[i].code[sizeof(LocalizationImageLanguage::code) - 1] != str::EOS) {
+                return false;
+            }
+        }
+
+        const auto* const labels = reinterpret_cast<const LocalizationImageLabel*>(image + header.labels_offset);
+
+        for (std::uint32_t i = 0; i < header.label_count; ++i) {
+            if (!string_fits(labels[i].offset, labels[i].length)) {
+                return false;
+            }
+        }
+
+        const auto* const slots = reinterpret_cast<const std::uint32_t*>(image + header.slots_offset);
+
+        std::uint32_t empty_slots{};
+
+        for (std::uint32_t i = 0; i < header.slot_count; ++i) {
+            if (slots[i] > header.label_count) {
+                return false;
+            }
+
+            empty_slots += slots[i] == 0 ? 1 : 0;
+        }
+
+        // At least one empty slot is required to terminate the lookup probing
+        if (empty_slots == 0) {
+            return false;
+        }
+
+        const auto* const texts = reinterpret_cast<const LocalizationImageText*>(image + header.texts_offset);
+
+        for (std::size_t i = 0; i < text_count; ++i) {
+            if (texts[i].offset != LocalizationTable::NPOS && !string_fits(texts[i].offset, texts[i].length)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Returns a fingerprint of the source file (path, size and modification time),
+     * or 0 if the file does not exist.
+    */
+    std::uint64_t GetFileFingerprint(const std::string& filepath)
+    {
+#ifdef _WIN32
+        struct _stat64 info{};
+        if (_stat64(filepath.c_str(), &info) != 0) {
+            return 0;
+        }
+#else
+        struct stat info{};
+        if (stat(filepath.c_str(), &info) != 0) {
+            return 0;
+        }
+#endif
+        auto fingerprint = HashLabel(filepath);
+        fingerprint = (fingerprint ^ static_cast<std::uint64_t>(info.st_size)) * 1099511628211ULL;
+        fingerprint = (fingerprint ^ static_cast<std::uint64_t>(info.st_mtime)) * 1099511628211ULL;
+
+        return fingerprint;
+    }
+
+    /**
+     * @brief Returns a combined fingerprint of the source files, or 0 if any of the files does not exist.
+    */
+    std::uint64_t GetFilesFingerprint(const std::vector<std::string>& filepaths)
+    {
+        std::uint64_t fingerprint = 14695981039346656037ULL;
+
+        for (const auto& filepath : filepaths) {
+            const auto file_fingerprint = GetFileFingerprint(filepath);
+
+            if (file_fingerprint == 0) {
+                return 0;
+            }
+
+            fingerprint = (fingerprint ^ file_fingerprint) * 1099511628211ULL;
+        }
+
+        return fingerprint;
+    }
+
+    /**
+     * @brief Maps the file into memory (read-only). Returns \c nullptr on failure.
+    */
+    std::shared_ptr<const void> MapFile(const std::string& filepath, std::size_t& size)
+    {
+#ifdef _WIN32
+        const auto file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+        if (file == INVALID_HANDLE_VALUE) {
+            return nullptr;
+        }
+
+        LARGE_INTEGER file_size{};
+        if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+            CloseHandle(file);
+            return nullptr;
+        }
+
+        const auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+
+        if (mapping == nullptr) {
+            return nullptr;
+        }
+
+        const auto* const view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+
+        if (view == nullptr) {
+            return nullptr;
+        }
+
+        size = static_cast<std::size_t>(file_size.QuadPart);
+
+        return {view, [](const void* const address) {
+                    UnmapViewOfFile(address);
+                }};
+#else
+        const auto file = open(filepath.c_str(), O_RDONLY);
+
+        if (file == -1) {
+            return nullptr;
+        }
+
+        struct stat info{};
+        if (fstat(file, &info) != 0 || info.st_size <= 0) {
+            close(file);
+            return nullptr;
+        }
+
+        auto* const address = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        close(file);
+
+        if (address == MAP_FAILED) {
+            return nullptr;
+        }
+
+        const auto length = static_cast<std::size_t>(info.st_size);
+        size = length;
+
+        return {address, [length](const void* const mapped) {
+                    munmap(const_cast<void*>(mapped), length);
+                }};
+#endif
+    }
+
+    std::shared_ptr<const void> LoadCache(const std::string& cache_path, const std::uint64_t fingerprint)
+    {
+        std::size_t size{};
+        auto image = MapFile(cache_path, size);
+
+        if (image && ValidateImage(static_cast<const std::byte*>(image.get()), size, fingerprint)) {
+            return image;
+        }
+
+        return nullptr;
+    }
+
+    void SaveCache(const std::string& cache_path, const std::shared_ptr<const void>& image)
+    {
+        LocalizationImageHeader header{};
+        std::memcpy(&header, image.get(), sizeof header);
+
+        // Write to a temporary file first, so a concurrent loader never maps a partially written cache.
+        const auto temp_path = cache_path + ".tmp";
+
 #ifdef MSVC_COMPILER
         std::FILE* stream{};
-        if (fopen_s(&stream, filepath.c_str(), "rt") || !stream) {
+        if (fopen_s(&stream, temp_path.c_str(), "wb") || !stream) {
             return;
         }
 #else
         std::FILE* stream{};
-        if (!((stream = std::fopen(filepath.c_str(), "r")))) {
+        if (!((stream = std::fopen(temp_path.c_str(), "wb")))) {
+            return;
+        }
+#endif
+
+        const auto written = std::fwrite(image.get(), 1, header.image_size, stream);
+        std::fclose(stream);
+
+        if (written != header.image_size) {
+            std::remove(temp_path.c_str());
             return;
         }
+
+#ifdef _WIN32
+        MoveFileExA(temp_path.c_str(), cache_path.c_str(), MOVEFILE_REPLACE_EXISTING);
+#else
+        std::rename(temp_path.c_str(), cache_path.c_str());
 #endif
+    }
 
-        char buffer[512];
-        std::size_t hash_lang{0};
-        constexpr std::hash<std::string_view> hasher{};
+    /**
+     * @brief Parses the localization file in a single pass over its memory mapped contents.
+     * Returns the number of parsed texts.
+    */
+    std::size_t Parse(const std::string& filepath, TableBuilder& builder)
+    {
+        std::size_t size{};
+        const auto file = MapFile(filepath, size);
+
+        if (!file) {
+            return 0;
+        }
 
-        while (std::fgets(buffer, sizeof buffer, stream)) {
-            const auto buffer_view = str::Trim(buffer);
+        std::string_view contents{static_cast<const char*>(file.get()), size};
+
+        // Skip UTF-8 BOM
+        if (contents.substr(0, 3) == "\xEF\xBB\xBF") {
+            contents.remove_prefix(3);
+        }
+
+        builder.Reserve(contents.size());
+
+        std::size_t count{};
+        auto language = LocalizationTable::NPOS;
+
+        while (!contents.empty()) {
+            const auto line_end = contents.find('\n');
+            const auto line = str::Trim(contents.substr(0, line_end));
+            contents.remove_prefix(line_end == std::string_view::npos ? contents.size() : line_end + 1);
 
             // Skip comment
-            if (buffer_view.length() < 3 || buffer_view.front() == ';' ||
-                buffer_view.front() == '/' || buffer_view.front() == '#') {
+            if (line.length() < 3 || line.front() == ';' || line.front() == '/' || line.front() == '#') {
                 continue;
             }
 
             // Parse language code
-            if (buffer_view.length() == 4 && buffer_view.front() == '[' && buffer_view.back() == ']') {
-                const auto lang = buffer_view.substr(1, 2);
-
-                languages.emplace_back(std::string{lang});
-                hash_lang = hasher(lang);
-
+            if (line.length() == 4 && line.front() == '[' && line.back() == ']') {
+                language = builder.AddLanguage(line.substr(1, 2));
                 continue;
             }
 
             // Parse label and text
-            if (hash_lang != 0) {
+            if (language != LocalizationTable::NPOS) {
                 std::string_view label{};
-                std::string text{};
-
-                if (SplitLabelText(buffer_view, label, text)) {
-                    str::ReplaceAll(text, "^1", std::string(1, 0x1));
-                    str::ReplaceAll(text, "^3", std::string(1, 0x3));
-                    str::ReplaceAll(text, "^4", std::string(1, 0x4));
+                std::string_view text{};
 
-                    localization[hash_lang + hasher(label)] = text;
+                if (SplitLabelText(line, label, text)) {
+                    builder.AddText(language, label, text);
+                    ++count;
                 }
             }
         }
 
-        std::fclose(stream);
+        return count;
+    }
+
+    std::string JoinPaths(const std::vector<std::string>& filepaths)
+    {
+        std::string paths{};
+
+        for (const auto& filepath : filepaths) {
+            if (!paths.empty()) {
+                paths.append(", ");
+            }
+
+            paths.append(filepath);
+        }
+
+        return paths;
+    }
+
+
+    /**
+     * @brief Loads the binary cache or parses the localization files. Does not touch the engine,
+     * so it can be called from a worker thread; messages are reported by the caller.
+    */
+    LocalizationBuild BuildLocalization(const std::vector<std::string>& filepaths, const bool binary_cache)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        LocalizationBuild build{};
+        const auto fingerprint = filepaths.empty() ? 0 : GetFilesFingerprint(filepaths);
+        const auto cache_path = filepaths.empty() ? std::string{} : filepaths.front() + ".cache";
+
+        if (binary_cache && fingerprint != 0) {
+            const auto start = Clock::now();
+
+            if ((build.image = LoadCache(cache_path, fingerprint))) {
+                build.messages.push_back(
+                    str::Format("Localization: loaded \"%s\" in %.2f ms.", cache_path,
+                                std::chrono::duration<double, std::milli>(Clock::now() - start).count()));
+
+                return build;
+            }
+        }
+
+        TableBuilder builder{};
+
+        for (const auto& filepath : filepaths) {
+            const auto start = Clock::now();
+            const auto count = Parse(filepath, builder);
+
+            build.messages.push_back(
+                str::Format("Localization: parsed \"%s\" (%zu texts) in %.2f ms.", filepath, count,
+                            std::chrono::duration<double, std::milli>(Clock::now() - start).count()));
+        }
+
+        if (builder.Empty()) {
+            return build;
+        }
+
+        build.image = builder.Build(fingerprint);
+
+        if (binary_cache && fingerprint != 0) {
+            SaveCache(cache_path, build.image);
+        }
+
+        return build;
+    }
+}
+
+namespace core::detail
+{
+    LocalizationTable::LocalizationTable(std::shared_ptr<const void> image)
+        : image_(std::move(image))
+    {
+        assert(image_ != nullptr);
+        const auto* const bytes = static_cast<const std::byte*>(image_.get());
+
+        header_ = reinterpret_cast<const LocalizationImageHeader*>(bytes);
+        languages_ = reinterpret_cast<const LocalizationImageLanguage*>(bytes + header_->languages_offset);
+        labels_ = reinterpret_cast<const LocalizationImageLabel*>(bytes + header_->labels_offset);
+        slots_ = reinterpret_cast<const std::uint32_t*>(bytes + header_->slots_offset);
+        texts_ = reinterpret_cast<const LocalizationImageText*>(bytes + header_->texts_offset);
+        arena_ = reinterpret_cast<const char*>(bytes + header_->arena_offset);
+
+        const auto en = FindLanguage("en");
+        default_language_ = en == NPOS ? 0 : en;
+    }
+
+    std::uint32_t LocalizationTable::FindLanguage(const std::string_view lang) const noexcept
+    {
+        for (std::uint32_t i = 0; i < header_->language_count; ++i) {
+            if (str::Equals(languages_[i].code, lang)) {
+                return i;
+            }
+        }
+
+        return NPOS;
+    }
+
+    std::uint32_t LocalizationTable::FindLabel(const std::string_view label, const std::uint64_t hash) const noexcept
+    {
+        const auto mask = header_->slot_count - 1;
+
+        for (auto slot = static_cast<std::uint32_t>(hash) & mask; slots_[slot] != 0; slot = (slot + 1) & mask) {
+            const auto label_id = slots_[slot] - 1;
+            const auto& entry = labels_[label_id];
+
+            if (entry.hash == hash && str::Equals(std::string_view{arena_ + entry.offset, entry.length}, label)) {
+                return label_id;
+            }
+        }
+
+        return NPOS;
     }
 }
 
 namespace core
 {
-    Localization::Localization(std::string filepath)
-        : filepath_(std::move(filepath))
+    Localization::Localization(std::string filepath, const bool binary_cache)
+        : Localization(std::vector<std::string>{std::move(filepath)}, binary_cache)
+    {
+    }
+
+    Localization::Localization(std::vector<std::string> filepaths, const bool binary_cache)
+        : filepaths_(std::move(filepaths)), binary_cache_(binary_cache)
     {
+#ifdef HAS_MHOOKS_LIB
+        InitLanguageCache();
+#endif
+        Publish(std::make_unique<const LocalizationSnapshot>());
         Reload();
     }
 
+    Localization::~Localization()
+    {
+        if (pending_build_.valid()) {
+            pending_build_.wait();
+        }
+    }
+
     void Localization::Reload()
     {
-        languages_.clear();
-        localization_.clear();
-        Parse(filepath_, languages_, localization_);
+        // The synchronous reload supersedes a pending background one.
+        if (pending_build_.valid()) {
+            pending_build_.get();
+        }
+
+        Publish(BuildLocalization(filepaths_, binary_cache_));
+    }
+
+    bool Localization::ReloadAsync()
+    {
+        if (pending_build_.valid()) {
+            return false;
+        }
+
+        pending_build_ = std::async(std::launch::async, BuildLocalization, filepaths_, binary_cache_);
+        ScheduleUpdate();
+
+        return true;
+    }
+
+    bool Localization::Update()
+    {
+        auto published = false;
 
-        if (localization_.empty()) {
+        if (pending_build_.valid() &&
+            pending_build_.wait_for(std::chrono::seconds::zero()) == std::future_status::ready) {
+            Publish(pending_build_.get());
+            published = true;
+        }
+
+#ifdef HAS_MHOOKS_LIB
+        if (!snapshot_.Reclaim() && !pending_build_.valid() && start_frame_hook_) {
+            start_frame_hook_->Disable();
+        }
+#else
+        snapshot_.Reclaim();
+#endif
+        return published;
+    }
+
+#ifdef HAS_MHOOKS_LIB
+    void Localization::OnStartFrame(const GameDllStartFrameMChain& chain)
+    {
+        Update();
+        chain.CallNext();
+    }
+#endif
+
+    void Localization::Publish(LocalizationBuild build)
+    {
+        for (const auto& message : build.messages) {
+            console::AlertMessageDeveloper("%s", message);
+        }
+
+        auto snapshot = std::make_unique<LocalizationSnapshot>();
+
+        if (build.image) {
+            snapshot->table = std::make_shared<const LocalizationTable>(std::move(build.image));
+        }
+
+        snapshot->resolved_ids.reserve(resolved_labels_.size());
+
+        for (const auto& label : resolved_labels_) {
+            snapshot->resolved_ids.push_back(snapshot->table ? snapshot->table->FindLabel(label) : LocalizationTable::NPOS);
+        }
+
+        const auto empty = snapshot->table == nullptr;
+        Publish(std::move(snapshot));
+
+        if (empty) {
             console::Message<false>(str::EMPTY);
-            console::Warning("Failed to parse localization file. Filepath: \"%s\"\n", filepath_);
+            console::Warning("Failed to parse localization file. Filepath: \"%s\"\n", JoinPaths(filepaths_));
+        }
+    }
+
+    void Localization::Publish(std::unique_ptr<const LocalizationSnapshot> snapshot)
+    {
+        if (snapshot_.Publish(std::move(snapshot))) {
+            ScheduleUpdate();
+        }
+    }
+
+    void Localization::ScheduleUpdate()
+    {
+#ifdef HAS_MHOOKS_LIB
+        if (start_frame_hook_) {
+            start_frame_hook_->Enable();
+        }
+        else {
+            start_frame_hook_ = MHookGameDllStartFrame({DELEGATE_ARG<&Localization::OnStartFrame>, this},
+                                                       false, HookChainPriority::Uninterruptable)
+                                    ->Unique();
+        }
+#endif
+    }
+
+    std::vector<std::string> Localization::FindFiles(const std::string& directory, const std::string_view extension)
+    {
+        std::vector<std::string> filepaths{};
+
+        const auto matches = [extension](const std::string_view filename) {
+            return filename.length() > extension.length() &&
+                filename.substr(filename.length() - extension.length()) == extension;
+        };
+
+#ifdef _WIN32
+        WIN32_FIND_DATAA data{};
+        const auto find = FindFirstFileA((directory + "\\*").c_str(), &data);
+
+        if (find != INVALID_HANDLE_VALUE) {
+            do {
+                if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && matches(data.cFileName)) {
+                    filepaths.push_back(directory + '/' + data.cFileName);
+                }
+            }
+            while (FindNextFileA(find, &data));
+
+            FindClose(find);
+        }
+#else
+        if (auto* const dir = opendir(directory.c_str())) {
+            while (const auto* const entry = readdir(dir)) {
+                if (entry->d_name[0] != '.' && matches(entry->d_name)) {
+                    filepaths.push_back(directory + '/' + entry->d_name);
+                }
+            }
+
+            closedir(dir);
+        }
+#endif
+        std::sort(filepaths.begin(), filepaths.end());
+
+        return filepaths;
+    }
+
+    LocLabel Localization::Resolve(const std::string_view label)
+    {
+        return Resolve(LocLabel{label});
+    }
+
+    LocLabel Localization::Resolve(const LocLabel label)
+    {
+        if (label.IsResolved()) {
+            assert(label.id_ < resolved_labels_.size() && str::Equals(resolved_labels_[label.id_], label.label_));
+            return label;
+        }
+
+        if (const auto it = resolved_label_ids_.find(label.label_); it != resolved_label_ids_.end()) {
+            return {resolved_labels_[it->second], label.hash_, it->second};
+        }
+
+        const auto id = static_cast<std::uint32_t>(resolved_labels_.size());
+        const auto& stored_label = resolved_labels_.emplace_back(label.label_);
+        const auto& table = snapshot_.Current()->table;
+        const auto table_id = table ? table->FindLabel(stored_label, label.hash_) : LocalizationTable::NPOS;
+
+        resolved_label_ids_.emplace(stored_label, id);
+
+        auto snapshot = std::make_unique<LocalizationSnapshot>(*snapshot_.Current());
+        snapshot->resolved_ids.push_back(table_id);
+        Publish(std::move(snapshot));
+
+        if (table_id == LocalizationTable::NPOS) {
+            console::Warning("Unknown localization label \"%s\". Filepath: \"%s\"\n", stored_label, JoinPaths(filepaths_));
+        }
+
+        return {stored_label, label.hash_, id};
+    }
+
+    std::uint32_t Localization::GetLabelId(const LocalizationSnapshot* const snapshot, const LocLabel label) noexcept
+    {
+        if (label.IsResolved()) {
+            return label.id_ < snapshot->resolved_ids.size() ? snapshot->resolved_ids[label.id_] : LocalizationTable::NPOS;
+        }
+
+        return snapshot->table && !label.label_.empty() ? snapshot->table->FindLabel(label.label_, label.hash_)
+                                                         : LocalizationTable::NPOS;
+    }
+
+    str::CStringView Localization::GetText(const LocalizationSnapshot* const snapshot, const std::string& lang,
+                                           const std::uint32_t label_id, Edict* const client) const
+    {
+        const auto& table = snapshot->table;
+
+        if (label_id == LocalizationTable::NPOS || !table) {
+            return notfound_;
+        }
+
+        const auto language = table->FindLanguage(GetLanguage(client, lang));
+        const auto* const text = table->FindText(language == LocalizationTable::NPOS ? table->DefaultLanguage() : language, label_id);
+
+        return text == nullptr ? str::CStringView{notfound_} : table->GetText(text);
+    }
+
+#ifdef HAS_MHOOKS_LIB
+    void Localization::GroupPlayers(const LocLabel label, LocalizationPlayerGroups& groups) const
+    {
+        const auto* const snapshot = snapshot_.Load();
+        const auto max_clients = g_global_vars->max_clients;
+
+        if (max_clients < 1 || max_clients > MAX_CLIENTS) {
+            return;
+        }
+
+        // Table language (or NPOS) of each connected player.
+        std::array<std::uint32_t, MAX_CLIENTS> player_languages{};
+        std::array<std::uint32_t, MAX_CLIENTS> group_languages{};
+        std::array<std::size_t, MAX_CLIENTS> group_sizes{};
+        std::array<Edict*, MAX_CLIENTS> players{};
+        std::size_t player_count{};
+
+        for (auto i = 1; i <= max_clients; ++i) {
+            auto* const client = type_conversion::EdictByIndex(i);
+
+            if (!IsValidEntity(client) || client->vars.flags & FL_FAKE_CLIENT) {
+                continue;
+            }
+
+            auto language = LocalizationTable::NPOS;
+
+            if (const auto& table = snapshot->table) {
+                const auto player_lang = GetPlayerLanguage(client);
+                language = table->FindLanguage(!player_lang.empty() ? player_lang : GetServerLanguage());
+                language = language == LocalizationTable::NPOS ? table->DefaultLanguage() : language;
+            }
+
+            std::size_t group = 0;
+            while (group < groups.group_count && group_languages[group] != language) {
+                ++group;
+            }
+
+            if (group == groups.group_count) {
+                group_languages[groups.group_count++] = language;
+            }
+
+            ++group_sizes[group];
+            player_languages[player_count] = language;
+            players[player_count++] = client;
+        }
+
+        const auto label_id = GetLabelId(snapshot, label);
+
+        for (std::size_t group = 0; group < groups.group_count; ++group) {
+            const auto* const text = label_id == LocalizationTable::NPOS || group_languages[group] == LocalizationTable::NPOS
+                ? nullptr
+                : snapshot->table->FindText(group_languages[group], label_id);
+
+            groups.texts[group] = text == nullptr ? str::CStringView{notfound_} : snapshot->table->GetText(text);
+            groups.offsets[group + 1] = groups.offsets[group] + group_sizes[group];
+        }
+
+        // Place the players of each group contiguously.
+        auto offsets = groups.offsets;
+
+        for (std::size_t i = 0; i < player_count; ++i) {
+            std::size_t group = 0;
+            while (group_languages[group] != player_languages[i]) {
+                ++group;
+            }
+
+            groups.players[offsets[group]++] = players[i];
         }
     }
+#endif
 
-    const std::string& Localization::GetText(const std::string& lang, const std::string_view label, Edict* const client) const
+    str::CStringView Localization::GetText(const std::string& lang, const std::string_view label, Edict* const client) const
     {
-        constexpr std::hash<std::string_view> hasher{};
+        const auto scope = Pin();
+        const auto* const snapshot = snapshot_.Load();
 
-        if (label.empty()) {
+        if (label.empty() || !snapshot->table) {
             return notfound_;
         }
 
-        const auto language = GetLanguage(client, lang);
-        const auto& it_find = localization_.find(hasher(IsLangInList(languages_, language) ? language : "en") + hasher(label));
+        return GetText(snapshot, lang, snapshot->table->FindLabel(label), client);
+    }
 
-        return it_find == localization_.end() ? notfound_ : it_find->second;
+    str::CStringView Localization::GetText(const std::string& lang, const LocLabel label, Edict* const client) const
+    {
+        const auto scope = Pin();
+        const auto* const snapshot = snapshot_.Load();
+        return GetText(snapshot, lang, GetLabelId(snapshot, label), client);
     }
 }
 #endif
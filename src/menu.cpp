@@ -19,13 +19,21 @@
 #include <core/menu.h>
 #include <amxx/api.h>
 #include <core/strings.h>
+#include <core/user_messages.h>
 #include <cssdk/public/utils.h>
 #include <metamod/engine.h>
 #include <metamod/utils.h>
 #include <algorithm>
 #include <cassert>
 #include <cerrno>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
 #include <utility>
 
 using namespace core;
@@ -36,11 +44,6 @@ using namespace metamod;
 
 namespace
 {
-    auto TruncateMenuText(const std::string_view text)
-    {
-        return str::Utf8Truncate(std::string{text}, 507);
-    }
-
     bool SetPlayerMenuOff(PlayerBase* const player)
     {
         if (player->has_disconnected) {
@@ -60,13 +63,12 @@ namespace
         return SetPlayerMenuOff(cssdk::EntityPrivateData<PlayerBase>(client));
     }
 
-    bool SendShowMenu(Edict* const client, const int keys, const int time, const std::string& text)
+    bool SendShowMenu(Edict* const client, const MenuPage& page, const int time)
     {
-        static int msg_show_menu{};
         static EngineFunctions* engine_funcs{};
         assert(metamod::utils::detail::funcs != nullptr);
 
-        if (!msg_show_menu && !((msg_show_menu = utils::GetUserMsgId("ShowMenu")))) {
+        if (!messages::UserMsgId(messages::UserMsg::ShowMenu)) {
             return false;
         }
 
@@ -78,25 +80,10 @@ namespace
             }
         }
 
-        const auto text_length = text.length();
-        std::string_view::size_type sent{0};
-        auto more = false;
-
-        do {
-            constexpr std::string_view::size_type chunk_size = 172; // Max 187
-            const auto chunk = std::string{text.substr(sent, chunk_size)};
-
-            sent += chunk_size;
-            more = sent < text_length;
-
-            engine_funcs->message_begin(MessageType::One, msg_show_menu, nullptr, client);
-            engine_funcs->write_short(keys);
-            engine_funcs->write_char(time);
-            engine_funcs->write_byte(more);
-            engine_funcs->write_string(chunk.c_str());
-            engine_funcs->message_end();
+        for (std::size_t i = 0, count = page.ChunkCount(); i < count; ++i) {
+            messages::schema::ShowMenu::Send(*engine_funcs, MessageType::One, client,
+                                             page.Keys(), time, i + 1 < count, page.Chunk(i).c_str());
         }
-        while (more);
 
         return true;
     }
@@ -104,69 +91,207 @@ namespace
 
 namespace core
 {
-    bool Menu::Show(Edict* const client, const int keys, const std::string_view text, const int time)
+    MenuPage::MenuPage(const int keys, const std::string_view text)
     {
-        const auto client_index = type_conversion::IndexOfEntity(client);
-        assert(IsClient(client_index));
+        Assign(keys, text);
+    }
 
-        if (SetPlayerMenuOff(client) && SendShowMenu(client, keys, time, TruncateMenuText(text))) {
-            keys_[client_index] = keys;
-            return true;
+    void MenuPage::Assign(const int keys, const std::string_view text)
+    {
+        keys_ = keys;
+        chunks_.clear();
+        chunk_offsets_.clear();
+
+        const auto truncated_text = str::Utf8TruncateView(text, TEXT_MAX_LENGTH);
+        std::size_t offset = 0;
+
+        // Each chunk is followed by a null terminator; an empty text is sent as one empty chunk.
+        chunks_.reserve(truncated_text.length() + truncated_text.length() / CHUNK_MAX_LENGTH + 1);
+
+        do {
+            const auto chunk = truncated_text.substr(offset, CHUNK_MAX_LENGTH);
+            offset += CHUNK_MAX_LENGTH;
+
+            chunk_offsets_.push_back(static_cast<std::uint32_t>(chunks_.length()));
+            chunks_.append(chunk).push_back(str::EOS);
         }
+        while (offset < truncated_text.length());
 
-        return false;
+        chunk_offsets_.push_back(static_cast<std::uint32_t>(chunks_.length()));
+
+        // Each message: keys (short), time (char), more (byte) and the null-terminated chunk.
+        hash_ = std::hash<std::string_view>{}(chunks_) ^ static_cast<std::size_t>(keys) * 0x9E3779B97F4A7C15ULL;
+        message_size_ = chunks_.length() + ChunkCount() * (sizeof(std::int16_t) + sizeof(std::int8_t) * 2);
     }
 
-    bool Menu::Show(const int keys, const std::string_view text, const int time)
+    MenuManager::MenuManager()
     {
-        const auto max_clients = g_global_vars->max_clients;
+        type_conversion::Init();
+        InitPlayerProps();
+        page_cache_index_.reserve(PAGE_CACHE_CAPACITY);
 
-        if (max_clients < 1 || max_clients > MAX_CLIENTS) {
-            return false;
-        }
+        hooks_.emplace_back(
+            MHookGameEvent("ShowMenu", {DELEGATE_ARG<&MenuManager::OnShowMenu>, this}, HookChainPriority::Uninterruptable)
+                ->Unique());
 
-        auto result{false};
-        const auto text_copy{TruncateMenuText(text)};
+        hooks_.emplace_back(
+            MHookGameEvent("VGUIMenu", {DELEGATE_ARG<&MenuManager::OnShowMenu>, this}, HookChainPriority::Uninterruptable)
+                ->Unique());
 
-        for (auto i = 1; i <= max_clients; ++i) {
-            Edict* const client = type_conversion::EdictByIndex(i);
+        hooks_.emplace_back(
+            MHookGameDllClientCommand({DELEGATE_ARG<&MenuManager::OnClientCommand>, this},
+                                      false, HookChainPriority::Uninterruptable)
+                ->Unique());
 
-            if (!IsValidEntity(client) || IsBot(client) || IsHltv(client)) {
-                continue;
-            }
+        hooks_.emplace_back(
+            MHookGameDllClientDisconnect({DELEGATE_ARG<&MenuManager::OnClientDisconnect>, this},
+                                         false, HookChainPriority::Uninterruptable)
+                ->Unique());
 
-            if (SetPlayerMenuOff(client) && SendShowMenu(client, keys, time, text_copy)) {
-                keys_[i] = keys;
-                result = true;
+        hooks_.emplace_back(
+            MHookGameDllServerActivate({DELEGATE_ARG<&MenuManager::OnServerActivatePost>, this},
+                                       true, HookChainPriority::Uninterruptable)
+                ->Unique());
+    }
+
+    MenuManager& MenuManager::Instance()
+    {
+        static MenuManager instance{};
+        return instance;
+    }
+
+    std::shared_ptr<const MenuPage> MenuManager::GetPage(const int keys, const std::string_view text)
+    {
+        const auto hash = std::hash<std::string_view>{}(text) ^ static_cast<std::size_t>(keys) * 0x9E3779B97F4A7C15ULL;
+
+        if (const auto it = page_cache_index_.find(hash); it != page_cache_index_.end()) {
+            page_cache_.splice(page_cache_.begin(), page_cache_, it->second);
+
+            if (const auto& cached = page_cache_.front(); cached.keys == keys && cached.text == text) {
+                return cached.page;
             }
+
+            // A hash collision: the entry is rebuilt for the new text.
         }
+        else if (page_cache_.size() < PAGE_CACHE_CAPACITY) {
+            page_cache_.emplace_front();
+            page_cache_index_.emplace(hash, page_cache_.begin());
+        }
+        else {
+            // The least recently used entry is reused for the new text.
+            page_cache_.splice(page_cache_.begin(), page_cache_, std::prev(page_cache_.end()));
 
-        return result;
+            auto node = page_cache_index_.extract(page_cache_.front().hash);
+            node.key() = hash;
+            page_cache_index_.insert(std::move(node));
+        }
+
+        auto& cached = page_cache_.front();
+        cached.hash = hash;
+        cached.keys = keys;
+        cached.text.assign(text);
+
+        // The buffers of the replaced page are reused unless a caller still holds it.
+        if (cached.page && cached.page.use_count() == 1) {
+            cached.page->Assign(keys, text);
+        }
+        else {
+            cached.page = std::make_shared<MenuPage>(keys, text);
+        }
+
+        return cached.page;
     }
 
-    void Menu::Close(Edict* const client)
+    MenuPage* MenuManager::AcquireScratchPage(const int keys, const std::string_view text)
     {
-        if (client) {
-            assert(IsValidEntity(client));
+        // An item menu shown from a hook of the ShowMenu message that is being sent gets a page of its own.
+        if (scratch_page_busy_) {
+            return nullptr;
+        }
 
-            if (IsOpen(client)) {
-                Show(client, 0, " ");
+        scratch_page_busy_ = true;
+        scratch_page_.Assign(keys, text);
+
+        return &scratch_page_;
+    }
+
+    void MenuManager::ReleaseScratchPage() noexcept
+    {
+        scratch_page_busy_ = false;
+    }
+
+    void MenuManager::SetPollInterval(const int frames)
+    {
+        poll_interval_ = std::max(frames, 0);
+        frames_until_poll_ = poll_interval_;
+
+        if (poll_interval_ == 0) {
+            if (start_frame_hook_) {
+                start_frame_hook_->Disable();
             }
         }
+        else if (start_frame_hook_) {
+            start_frame_hook_->Enable();
+        }
         else {
-            if (const auto max_clients = g_global_vars->max_clients; max_clients > 0 && max_clients <= MAX_CLIENTS) {
-                for (auto i = 1; i <= max_clients; ++i) {
-                    if (IsOpen(i)) {
-                        if (Edict* const edict = type_conversion::EdictByIndex(i); IsValidEntity(edict)) {
-                            Show(edict, 0, " ");
-                        }
-                    }
-                }
+            start_frame_hook_ = MHookGameDllStartFrame({DELEGATE_ARG<&MenuManager::OnStartFrame>, this},
+                                                       false, HookChainPriority::Uninterruptable)
+                                    ->Unique();
+        }
+    }
+
+    void MenuManager::Open(const int player, Menu* const menu, const MenuPage& page)
+    {
+        // Bots and HLTV proxies never select a menu item.
+        if (const auto* const client = type_conversion::EdictByIndex(player);
+            !page.Keys() || client->vars.flags & FL_FAKE_CLIENT || client->vars.flags & FL_PROXY) {
+            Close(player);
+            return;
+        }
+
+        active_menus_[player] = menu;
+        keys_[player] = page.Keys();
+        page_hashes_[player] = page.Hash();
+    }
+
+    bool MenuManager::SkipRedraw(const int player, const Menu* const menu, const MenuPage& page, const int time)
+    {
+        // A menu with a timeout is sent again to restart it.
+        if (time >= 0 || active_menus_[player] != menu || keys_[player] != page.Keys() ||
+            page_hashes_[player] != page.Hash()) {
+            return false;
+        }
+
+        saved_bytes_ += page.MessageSize();
+        return true;
+    }
+
+    void MenuManager::Close(const int player)
+    {
+        active_menus_[player] = nullptr;
+        keys_[player] = 0;
+        page_hashes_[player] = 0;
+    }
+
+    void MenuManager::Detach(const Menu* const menu)
+    {
+        for (auto i = 1; i <= MAX_CLIENTS; ++i) {
+            if (active_menus_[i] == menu) {
+                Close(i);
             }
         }
     }
 
-    void Menu::InitPlayerProps()
+    void MenuManager::Relocate(const Menu* const from, Menu* const to)
+    {
+        for (auto i = 1; i <= MAX_CLIENTS; ++i) {
+            if (active_menus_[i] == from) {
+                active_menus_[i] = to;
+            }
+        }
+    }
+
+    void MenuManager::InitPlayerProps()
     {
         player_prop_menu_.fill(nullptr);
         player_prop_newmenu_.fill(nullptr);
@@ -182,25 +307,30 @@ namespace core
         }
     }
 
-    void Menu::OnServerActivatePost(const GameDllServerActivateMChain& chain, Edict* const edict_list,
-                                    const int edict_count, const int client_max)
+    void MenuManager::OnServerActivatePost(const GameDllServerActivateMChain& chain, Edict* const edict_list,
+                                           const int edict_count, const int client_max)
     {
         InitPlayerProps();
+        active_menus_.fill(nullptr);
+        keys_.fill(0);
+        page_hashes_.fill(0);
+
         chain.CallNext(edict_list, edict_count, client_max);
     }
 
-    void Menu::OnShowMenu(const MessageType, const int, const float* const, const Edict* const client, const MessageArgs&)
+    void MenuManager::OnShowMenu(const MessageType, const int, const float* const, const Edict* const client,
+                                 const MessageArgs&)
     {
         if (!IsValidEntity(client)) {
             return;
         }
 
         if (const auto client_index = type_conversion::IndexOfEntity(client); IsClient(client_index)) {
-            keys_[client_index] = 0;
+            Close(client_index);
         }
     }
 
-    void Menu::OnClientCommand(const GameDllClientCommandMChain& chain, Edict* const client)
+    void MenuManager::OnClientCommand(const GameDllClientCommandMChain& chain, Edict* const client)
     {
         chain.CallNext(client);
 
@@ -217,99 +347,290 @@ namespace core
 
             if (const auto* const cmd_arg = engine::CmdArgv(1); !str::IsNullOrWhiteSpace(cmd_arg)) {
                 errno = 0;
+                const auto* const menu = active_menus_[client_index];
 
-                if (!handler_) {
-                    keys_[client_index] = 0;
+                if (!menu->handler_) {
+                    Close(client_index);
                 }
                 else if (auto selected_item = static_cast<int>(std::strtol(cmd_arg, nullptr, 10));
                          errno == 0 && selected_item != 0) {
                     selected_item = std::clamp(selected_item, 1, 10);
 
                     if (keys_[client_index] & (1 << (selected_item - 1))) {
-                        keys_[client_index] = 0;
-                        handler_(client, selected_item == 10 ? 0 : selected_item);
+                        Close(client_index);
+                        menu->handler_(client, selected_item == 10 ? 0 : selected_item);
                     }
                 }
             }
         }
     }
 
-    void Menu::OnPlayerPreThink(const GameDllPlayerPreThinkMChain& chain, Edict* const client)
+    void MenuManager::OnClientDisconnect(const GameDllClientDisconnectMChain& chain, Edict* const client)
     {
+        if (IsValidEntity(client)) {
+            if (const auto client_index = type_conversion::IndexOfEntity(client); IsClient(client_index)) {
+                Close(client_index);
+            }
+        }
+
         chain.CallNext(client);
+    }
 
-        if (!IsValidEntity(client)) {
-            return;
+    void MenuManager::OnStartFrame(const GameDllStartFrameMChain& chain)
+    {
+        if (--frames_until_poll_ <= 0) {
+            frames_until_poll_ = poll_interval_;
+            PollPlayerMenus();
         }
 
-        if (const auto client_index = type_conversion::IndexOfEntity(client);
-            IsClient(client_index) && keys_[client_index]) {
-            assert(player_prop_menu_[client_index] != nullptr);
-            assert(player_prop_newmenu_[client_index] != nullptr);
+        chain.CallNext();
+    }
+
+    void MenuManager::PollPlayerMenus()
+    {
+        const auto max_clients = std::min(g_global_vars->max_clients, MAX_CLIENTS);
+
+        for (auto i = 1; i <= max_clients; ++i) {
+            if (!keys_[i]) {
+                continue;
+            }
+
+            assert(player_prop_menu_[i] != nullptr);
+            assert(player_prop_newmenu_[i] != nullptr);
 
-            if ((client->vars.flags & FL_FAKE_CLIENT) || (client->vars.flags & FL_PROXY) ||
-                *player_prop_menu_[client_index] != 0 || *player_prop_newmenu_[client_index] != -1) {
-                keys_[client_index] = 0;
+            if (*player_prop_menu_[i] != 0 || *player_prop_newmenu_[i] != -1) {
+                Close(i);
             }
         }
     }
 
-    void Menu::CreateHooks()
+    bool Menu::Show(Edict* const client, const int keys, const std::string_view text, const int time)
     {
-        hooks_.clear();
+        return Show(client, *MenuManager::Instance().GetPage(keys, text), time);
+    }
 
-        hooks_.emplace_back(
-            MHookGameEvent("ShowMenu", {DELEGATE_ARG<&Menu::OnShowMenu>, this}, HookChainPriority::Uninterruptable)
-                ->Unique());
+    bool Menu::Show(const int keys, const std::string_view text, const int time)
+    {
+        return Show(*MenuManager::Instance().GetPage(keys, text), time);
+    }
 
-        hooks_.emplace_back(
-            MHookGameEvent("VGUIMenu", {DELEGATE_ARG<&Menu::OnShowMenu>, this}, HookChainPriority::Uninterruptable)
-                ->Unique());
+    bool Menu::Show(Edict* const client, const MenuPage& page, const int time)
+    {
+        const auto client_index = type_conversion::IndexOfEntity(client);
+        assert(IsClient(client_index));
 
-        hooks_.emplace_back(
-            MHookGameDllClientCommand({DELEGATE_ARG<&Menu::OnClientCommand>, this},
-                                      false, HookChainPriority::Uninterruptable)
-                ->Unique());
+        auto& manager = MenuManager::Instance();
 
-        hooks_.emplace_back(
-            MHookGameDllPlayerPreThink({DELEGATE_ARG<&Menu::OnPlayerPreThink>, this},
-                                       false, HookChainPriority::Uninterruptable)
-                ->Unique());
+        if (manager.SkipRedraw(client_index, this, page, time)) {
+            return true;
+        }
 
-        hooks_.emplace_back(
-            MHookGameDllServerActivate({DELEGATE_ARG<&Menu::OnServerActivatePost>, this},
-                                       true, HookChainPriority::Uninterruptable)
-                ->Unique());
+        if (SetPlayerMenuOff(client) && SendShowMenu(client, page, time)) {
+            manager.Open(client_index, this, page);
+            return true;
+        }
+
+        return false;
     }
 
-    Menu::Menu(const MenuHandler handler)
-        : handler_(handler)
+    bool Menu::Show(const MenuPage& page, const int time)
     {
-        keys_.fill(0);
-        type_conversion::Init();
-        InitPlayerProps();
-        CreateHooks();
+        const auto max_clients = g_global_vars->max_clients;
+
+        if (max_clients < 1 || max_clients > MAX_CLIENTS) {
+            return false;
+        }
+
+        auto result{false};
+        auto& manager = MenuManager::Instance();
+
+        for (auto i = 1; i <= max_clients; ++i) {
+            Edict* const client = type_conversion::EdictByIndex(i);
+
+            if (!IsValidEntity(client) || IsBot(client) || IsHltv(client)) {
+                continue;
+            }
+
+            if (manager.SkipRedraw(i, this, page, time)) {
+                result = true;
+            }
+            else if (SetPlayerMenuOff(client) && SendShowMenu(client, page, time)) {
+                manager.Open(i, this, page);
+                result = true;
+            }
+        }
+
+        return result;
+    }
+
+    void Menu::Close(Edict* const client)
+    {
+        if (client) {
+            assert(IsValidEntity(client));
+
+            if (IsOpen(client)) {
+                Show(client, 0, " ");
+            }
+        }
+        else {
+            if (const auto max_clients = g_global_vars->max_clients; max_clients > 0 && max_clients <= MAX_CLIENTS) {
+                for (auto i = 1; i <= max_clients; ++i) {
+                    if (IsOpen(i)) {
+                        if (Edict* const edict = type_conversion::EdictByIndex(i); IsValidEntity(edict)) {
+                            Show(edict, 0, " ");
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    Menu::Menu(MenuHandler handler)
+        : handler_(std::move(handler))
+    {
+        // Installs the menu hooks once for all menus.
+        [[maybe_unused]] auto& manager = MenuManager::Instance();
+    }
+
+    Menu::~Menu()
+    {
+        MenuManager::Instance().Detach(this);
     }
 
     Menu::Menu(Menu&& other) noexcept // NOLINT(bugprone-exception-escape)
-        : handler_(other.handler_)
+        : handler_(std::move(other.handler_))
     {
-        *this = std::move(other);
+        MenuManager::Instance().Relocate(&other, this);
     }
 
     Menu& Menu::operator=(Menu&& other) noexcept // NOLINT(bugprone-exception-escape)
     {
-        keys_ = other.keys_;
-        handler_ = other.handler_;
-        player_prop_menu_ = other.player_prop_menu_;
-        player_prop_newmenu_ = other.player_prop_newmenu_;
-
-        // We cannot move the hooks (Delegates).
-        // Because they will hold the old class pointer.
-        // Create again.
-        CreateHooks();
+        if (this != &other) {
+            auto& manager = MenuManager::Instance();
+            manager.Detach(this);
+            manager.Relocate(&other, this);
+            handler_ = std::move(other.handler_);
+        }
 
         return *this;
     }
+
+    ItemMenu::ItemMenu(std::string title, ItemHandler handler)
+        : menu_({DELEGATE_ARG<&ItemMenu::OnSelect>, this}), handler_(std::move(handler)), title_(std::move(title))
+    {
+    }
+
+    void ItemMenu::SetNavigationTexts(std::string back, std::string next, std::string exit)
+    {
+        back_text_ = std::move(back);
+        next_text_ = std::move(next);
+        exit_text_ = std::move(exit);
+    }
+
+    std::size_t ItemMenu::AddItem(std::string text, ItemEnabled enabled)
+    {
+        items_.push_back({std::move(text), std::move(enabled)});
+        return items_.size() - 1;
+    }
+
+    bool ItemMenu::Show(Edict* const client, const std::size_t page, const int time)
+    {
+        const auto client_index = type_conversion::IndexOfEntity(client);
+        assert(IsClient(client_index));
+
+        pages_[client_index] = static_cast<std::uint32_t>(std::min(page, PageCount() - 1));
+        const auto keys = Render(client, pages_[client_index]);
+
+        // Rendered pages differ per player and page, so they bypass the page cache.
+        auto& manager = MenuManager::Instance();
+
+        if (auto* const scratch_page = manager.AcquireScratchPage(keys, buffer_)) {
+            const auto result = menu_.Show(client, *scratch_page, time);
+            manager.ReleaseScratchPage();
+
+            return result;
+        }
+
+        return menu_.Show(client, MenuPage{keys, buffer_}, time);
+    }
+
+    int ItemMenu::Render(Edict* const client, const std::size_t page)
+    {
+        const auto page_count = PageCount();
+        const auto first = page * ITEMS_PER_PAGE;
+        const auto last = std::min(first + ITEMS_PER_PAGE, items_.size());
+        auto keys = 0;
+
+        const auto append_item = [this, &keys](const int key, const std::string& text, const bool enabled) {
+            const auto digit = static_cast<char>('0' + key % 10);
+
+            if (enabled) {
+                keys |= 1 << (key - 1);
+                buffer_.append("\\r").append(1, digit).append(".\\w ");
+            }
+            else {
+                buffer_.append("\\d").append(1, digit).append(". ");
+            }
+
+            buffer_.append(text).append(1, '\n');
+        };
+
+        // The buffer keeps its capacity, only the shown page is rendered.
+        buffer_.clear();
+        buffer_.append("\\y").append(title_);
+
+        if (page_count > 1) {
+            buffer_.append(" \\d").append(std::to_string(page + 1)).append(1, '/').append(std::to_string(page_count));
+        }
+
+        buffer_.append("\n\n");
+
+        for (auto i = first; i < last; ++i) {
+            const auto& item = items_[i];
+            append_item(static_cast<int>(i - first + 1), item.text, !item.enabled || item.enabled(client));
+        }
+
+        buffer_.append(1, '\n');
+
+        if (page_count > 1) {
+            append_item(8, back_text_, page > 0);
+            append_item(9, next_text_, page + 1 < page_count);
+        }
+
+        append_item(10, exit_text_, true);
+
+        return keys;
+    }
+
+    void ItemMenu::OnSelect(Edict* const client, const int selected_item)
+    {
+        const auto client_index = type_conversion::IndexOfEntity(client);
+        const auto page = static_cast<std::size_t>(pages_[client_index]);
+
+        switch (selected_item) {
+        case 0:
+            if (handler_) {
+                handler_(client, EXIT);
+            }
+            break;
+
+        case 8:
+            Show(client, page - 1);
+            break;
+
+        case 9:
+            Show(client, page + 1);
+            break;
+
+        default:
+            // The item may have been disabled since the page was rendered (e.g. a vote that has closed).
+            if (const auto item = page * ITEMS_PER_PAGE + selected_item - 1; item < items_.size() && handler_) {
+                if (const auto& enabled = items_[item].enabled; !enabled || enabled(client)) {
+                    handler_(client, item);
+                }
+            }
+            break;
+        }
+    }
 }
 #endif
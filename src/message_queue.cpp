@@ -0,0 +1,276 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if defined(HAS_METAMOD_LIB) && defined(HAS_MHOOKS_LIB)
+#include <core/message_queue.h>
+#include <core/strings/mutation.h>
+#include <core/type_conversion.h>
+#include <algorithm>
+
+using namespace core;
+using namespace cssdk;
+using namespace mhooks;
+
+namespace
+{
+    // svc_usermessage, message ID and size of a variable-size user message.
+    constexpr std::size_t USER_MESSAGE_HEADER_SIZE = 2;
+
+    // svc_temp_entity, TE_TEXT_MESSAGE and the fixed HUD message fields.
+    constexpr std::size_t HUD_MESSAGE_HEADER_SIZE = 22;
+
+    std::size_t MessageSize(const HudTextParams* const hud_params, const std::size_t text_length)
+    {
+        if (hud_params) {
+            return HUD_MESSAGE_HEADER_SIZE + (hud_params->effect == 2 ? sizeof(std::int16_t) : 0) + text_length + 1;
+        }
+
+        // Destination or sender byte, then the null-terminated text.
+        return USER_MESSAGE_HEADER_SIZE + 1 + text_length + 1;
+    }
+}
+
+namespace core::messages
+{
+    MessageQueue::MessageQueue()
+    {
+        type_conversion::Init();
+
+        hooks_.emplace_back(
+            MHookGameDllClientDisconnect({DELEGATE_ARG<&MessageQueue::OnClientDisconnect>, this},
+                                         false, HookChainPriority::Uninterruptable)
+                ->Unique());
+
+        hooks_.emplace_back(
+            MHookGameDllServerDeactivate({DELEGATE_ARG<&MessageQueue::OnServerDeactivatePost>, this},
+                                         true, HookChainPriority::Uninterruptable)
+                ->Unique());
+    }
+
+    MessageQueue& MessageQueue::Instance()
+    {
+        static MessageQueue instance{};
+        return instance;
+    }
+
+    void MessageQueue::SetEnabled(const bool enabled)
+    {
+        if (!enabled && pending_) {
+            collecting_ = false;
+
+            for (auto i = 1; i <= MAX_CLIENTS; ++i) {
+                FlushClient(i, 0);
+            }
+
+            arena_.clear();
+        }
+
+        enabled_ = enabled;
+        collecting_ = enabled;
+        UpdateStartFrameHook();
+    }
+
+    void MessageQueue::Flush()
+    {
+        collecting_ = false;
+        spare_arena_.clear();
+
+        for (auto i = 1; i <= MAX_CLIENTS; ++i) {
+            FlushClient(i, client_budget_);
+        }
+
+        arena_.swap(spare_arena_);
+        collecting_ = enabled_;
+        UpdateStartFrameHook();
+    }
+
+    void MessageQueue::Clear()
+    {
+        for (auto i = 1; i <= MAX_CLIENTS; ++i) {
+            queues_[i].clear();
+        }
+
+        arena_.clear();
+        pending_ = 0;
+        UpdateStartFrameHook();
+    }
+
+    void MessageQueue::PostTextMessage(const PlayerSet& clients, const HudPrint dest, const str::CStringView text)
+    {
+        Post(clients, Kind::TextMsg, static_cast<int>(dest), {}, text, TEXT_MAX_LENGTH);
+    }
+
+    void MessageQueue::PostChatMessage(const PlayerSet& clients, const int sender, const str::CStringView text)
+    {
+        Post(clients, Kind::SayText, sender, {}, text, TEXT_MAX_LENGTH);
+    }
+
+    void MessageQueue::PostHudMessage(const PlayerSet& clients, const HudTextParams& hud_params,
+                                      const str::CStringView text)
+    {
+        Post(clients, Kind::Hud, 0, hud_params, text, HUD_TEXT_MAX_LENGTH);
+    }
+
+    void MessageQueue::Post(const PlayerSet& clients, const Kind kind, const int arg, const HudTextParams& hud_params,
+                            const str::CStringView text, const std::size_t max_length)
+    {
+        const auto recipients = clients & PlayerSet::Connected();
+
+        if (recipients.Empty()) {
+            return;
+        }
+
+        // The text is truncated and stored once for all recipients.
+        const auto truncated = str::Utf8TruncateView(text, max_length);
+        const auto text_offset = static_cast<std::uint32_t>(arena_.length());
+        arena_.append(truncated).push_back(str::EOS);
+
+        const Entry entry{kind, arg, text_offset, static_cast<std::uint32_t>(truncated.length()),
+                          static_cast<std::uint32_t>(MessageSize(kind == Kind::Hud ? &hud_params : nullptr,
+                                                                 truncated.length())),
+                          hud_params};
+
+        recipients.ForEach([this, &entry](const int client) {
+            auto& queue = queues_[client];
+
+            // The client replaces the HUD message of a channel with the next one, so the queued one is never seen.
+            if (entry.kind == Kind::Hud) {
+                const auto channel = entry.hud_params.channel & 0xFF;
+                const auto it = std::find_if(queue.begin(), queue.end(), [channel](const Entry& queued) {
+                    return queued.kind == Kind::Hud && (queued.hud_params.channel & 0xFF) == channel;
+                });
+
+                if (it != queue.end()) {
+                    queue.erase(it);
+                    --pending_;
+                    ++stats_.superseded;
+                }
+            }
+
+            queue.push_back(entry);
+            ++pending_;
+            ++stats_.posted;
+        });
+
+        UpdateStartFrameHook();
+    }
+
+    void MessageQueue::FlushClient(const int client, const std::size_t budget)
+    {
+        auto& queue = queues_[client];
+
+        if (queue.empty()) {
+            return;
+        }
+
+        auto* const edict = type_conversion::EdictByIndex(client);
+
+        if (!IsValidEntity(edict)) {
+            ClearClient(client);
+            return;
+        }
+
+        std::size_t sent = 0;
+        std::size_t sent_bytes = 0;
+
+        for (const auto& entry : queue) {
+            // The first message is sent even if it does not fit, so an oversized message cannot block the queue.
+            if (budget && sent && sent_bytes + entry.size > budget) {
+                break;
+            }
+
+            const str::CStringView text{arena_.data() + entry.text_offset, entry.text_length};
+
+            switch (entry.kind) {
+            case Kind::TextMsg:
+                SendTextMessage(edict, static_cast<HudPrint>(entry.arg), text);
+                break;
+
+            case Kind::SayText:
+                SendChatMessage(edict, entry.arg, text);
+                break;
+
+            case Kind::Hud:
+                SendHudMessage(edict, entry.hud_params, text);
+                break;
+            }
+
+            ++sent;
+            sent_bytes += entry.size;
+        }
+
+        queue.erase(queue.begin(), queue.begin() + static_cast<std::ptrdiff_t>(sent));
+        pending_ -= sent;
+        stats_.sent += sent;
+        stats_.carried += queue.size();
+
+        // Move the texts of the leftovers to the arena of the next frame.
+        for (auto& entry : queue) {
+            const auto text_offset = static_cast<std::uint32_t>(spare_arena_.length());
+            spare_arena_.append(arena_, entry.text_offset, entry.text_length + 1);
+            entry.text_offset = text_offset;
+        }
+    }
+
+    void MessageQueue::ClearClient(const int client)
+    {
+        pending_ -= queues_[client].size();
+        queues_[client].clear();
+    }
+
+    void MessageQueue::UpdateStartFrameHook()
+    {
+        // The hook is disabled while the queue is empty.
+        if (!pending_) {
+            if (start_frame_hook_) {
+                start_frame_hook_->Disable();
+            }
+        }
+        else if (start_frame_hook_) {
+            start_frame_hook_->Enable();
+        }
+        else {
+            start_frame_hook_ = MHookGameDllStartFrame({DELEGATE_ARG<&MessageQueue::OnStartFrame>, this},
+                                                       false, HookChainPriority::Uninterruptable)
+                                    ->Unique();
+        }
+    }
+
+    void MessageQueue::OnStartFrame(const GameDllStartFrameMChain& chain)
+    {
+        Flush();
+        chain.CallNext();
+    }
+
+    void MessageQueue::OnClientDisconnect(const GameDllClientDisconnectMChain& chain, Edict* const client)
+    {
+        if (IsValidEntity(client)) {
+            if (const auto client_index = type_conversion::IndexOfEntity(client); IsClient(client_index)) {
+                ClearClient(client_index);
+            }
+        }
+
+        chain.CallNext(client);
+    }
+
+    void MessageQueue::OnServerDeactivatePost(const GameDllServerDeactivateMChain& chain)
+    {
+        Clear();
+        chain.CallNext();
+    }
+}
+#endif
@@ -17,61 +17,111 @@
 
 #ifdef HAS_METAMOD_LIB
 #include <core/messages.h>
-#include <core/strings/mutation.h>
+#include <core/message_queue.h>
+#include <core/type_conversion.h>
+#include <core/user_messages.h>
 #include <cssdk/public/utils.h>
 #include <metamod/engine.h>
-#include <metamod/utils.h>
+#include <cstddef>
 
 using namespace cssdk;
 using namespace metamod;
 
 namespace
 {
-    void SendMessageInternal(const int id, Edict* const client, const int dest, const std::string& text)
+#ifdef HAS_MHOOKS_LIB
+    core::PlayerSet Recipients(const Edict* const client)
     {
-        engine::MessageBegin(client ? MessageType::One : MessageType::All, id, nullptr, client);
-        engine::WriteByte(dest);
-
-        if (text.size() > 190) {
-            const auto text_copy = core::str::Utf8Truncate(text, 190);
-            engine::WriteString(text_copy.c_str());
-        }
-        else {
-            engine::WriteString(text.c_str());
+        if (!client) {
+            return core::PlayerSet::Connected();
         }
 
-        engine::MessageEnd();
+        core::PlayerSet recipients{};
+        recipients.Add(client);
+
+        return recipients;
     }
-}
+#endif
 
-namespace core::messages
-{
-    void SendTextMessage(Edict* const client, const HudPrint dest, const std::string& text)
+    /**
+     * @brief Returns a null-terminated text of at most \c Size bytes.
+     * Long text is truncated once into the \c buffer, so it can be written to any number of messages.
+    */
+    template <std::size_t Size>
+    const char* PrepareText(const core::str::CStringView text, core::str::FixedString<Size>& buffer)
     {
-        if (static auto msg_text = 0; msg_text || ((msg_text = utils::GetUserMsgId("TextMsg")))) {
-            SendMessageInternal(msg_text, client, static_cast<int>(dest), text);
+        if (text.length() > Size) {
+            // The truncated view is not null-terminated, copy it to the stack.
+            return buffer.assign(text).c_str();
         }
+
+        return text.c_str();
     }
 
-    void SendChatMessage(Edict* const client, const int sender, const std::string& text)
+    template <typename Schema>
+    void SendMessageInternal(Edict* const client, const int dest, const core::str::CStringView text)
     {
-        if (static auto msg_say_text = 0; msg_say_text || ((msg_say_text = utils::GetUserMsgId("SayText")))) {
-            SendMessageInternal(msg_say_text, client, sender, text);
-        }
+        core::messages::TextString buffer;
+        Schema::Send(client ? MessageType::One : MessageType::All, client, dest, PrepareText(text, buffer));
     }
 
-    void SendChatColorMessage(Edict* const client, const std::string& text, const SayTextTeamColor color)
+#ifdef HAS_MHOOKS_LIB
+    template <typename Schema>
+    void SendMessageInternal(const core::PlayerSet& clients, const int dest, const core::str::CStringView text)
     {
-        const auto client_index = engine::IndexOfEdict(client);
-        SendChatMessage(client, color == SayTextTeamColor::Default ? client_index : static_cast<int>(color), text);
+        const auto connected = core::PlayerSet::Connected();
+        const auto recipients = clients & connected;
+
+        if (recipients.Empty() || !core::messages::UserMsgId(Schema::MESSAGE)) {
+            return;
+        }
+
+        core::messages::TextString buffer;
+        const auto* const payload = PrepareText(text, buffer);
+
+        if (recipients == connected) {
+            Schema::Send(MessageType::All, nullptr, dest, payload);
+            return;
+        }
+
+        recipients.ForEach([dest, payload](const int index) {
+            Schema::Send(MessageType::One, core::type_conversion::EdictByIndex(index), dest, payload);
+        });
     }
+#endif
 
-    void SendChatColorMessage(Edict* const client, const int sender, const std::string& text, const SayTextTeamColor color)
+    /**
+     * @brief HUD message fields converted to their network representation.
+    */
+    struct HudPayload
     {
-        SendChatMessage(client, color == SayTextTeamColor::Default ? sender : static_cast<int>(color), text);
+        int channel;
+        int x;
+        int y;
+        int effect;
+        int fade_in_time;
+        int fade_out_time;
+        int hold_time;
+        int fx_time;
+        const char* text;
+    };
+
+    HudPayload PrepareHudPayload(const HudTextParams& hud_params, const core::str::CStringView text,
+                                 core::messages::HudTextString& buffer)
+    {
+        return HudPayload{
+            hud_params.channel & 0xFF,
+            FixedSigned16(hud_params.x, 1 << 13),
+            FixedSigned16(hud_params.y, 1 << 13),
+            hud_params.effect,
+            FixedUnsigned16(hud_params.fade_in_time, 1 << 8),
+            FixedUnsigned16(hud_params.fade_out_time, 1 << 8),
+            FixedUnsigned16(hud_params.hold_time, 1 << 8),
+            FixedUnsigned16(hud_params.fx_time, 1 << 8),
+            PrepareText(text, buffer)};
     }
 
-    void SendHudMessage(Edict* const client, const HudTextParams& hud_params, const std::string& text)
+    void WriteHudMessage(Edict* const client, const HudTextParams& hud_params, const HudPayload& payload)
     {
         if (constexpr auto svc_temp_entity = static_cast<int>(SvcMessage::TempEntity); client) {
             engine::MessageBegin(MessageType::OneUnreliable, svc_temp_entity, nullptr, client);
@@ -81,10 +131,10 @@ namespace core::messages
         }
 
         engine::WriteByte(TE_TEXT_MESSAGE);
-        engine::WriteByte(hud_params.channel & 0xFF);
-        engine::WriteShort(FixedSigned16(hud_params.x, 1 << 13));
-        engine::WriteShort(FixedSigned16(hud_params.y, 1 << 13));
-        engine::WriteByte(hud_params.effect);
+        engine::WriteByte(payload.channel);
+        engine::WriteShort(payload.x);
+        engine::WriteShort(payload.y);
+        engine::WriteByte(payload.effect);
         engine::WriteByte(hud_params.red1);
         engine::WriteByte(hud_params.green1);
         engine::WriteByte(hud_params.blue1);
@@ -93,24 +143,128 @@ namespace core::messages
         engine::WriteByte(hud_params.green2);
         engine::WriteByte(hud_params.blue2);
         engine::WriteByte(hud_params.alpha2);
-        engine::WriteShort(FixedUnsigned16(hud_params.fade_in_time, 1 << 8));
-        engine::WriteShort(FixedUnsigned16(hud_params.fade_out_time, 1 << 8));
-        engine::WriteShort(FixedUnsigned16(hud_params.hold_time, 1 << 8));
+        engine::WriteShort(payload.fade_in_time);
+        engine::WriteShort(payload.fade_out_time);
+        engine::WriteShort(payload.hold_time);
 
-        if (hud_params.effect == 2) {
-            engine::WriteShort(FixedUnsigned16(hud_params.fx_time, 1 << 8));
+        if (payload.effect == 2) {
+            engine::WriteShort(payload.fx_time);
         }
 
-        // The maximum net message size is 512 bytes. There are only 489 bytes left for the string.
-        if (text.size() > 489) {
-            const auto text_copy = str::Utf8Truncate(text, 489);
-            engine::WriteString(text_copy.c_str());
+        engine::WriteString(payload.text);
+        engine::MessageEnd();
+    }
+}
+
+namespace core::messages
+{
+    void SendTextMessage(Edict* const client, const HudPrint dest, const str::CStringView text)
+    {
+#ifdef HAS_MHOOKS_LIB
+        if (MessageQueue::IsCollecting()) {
+            MessageQueue::Instance().PostTextMessage(Recipients(client), dest, text);
+            return;
         }
-        else {
-            engine::WriteString(text.c_str());
+#endif
+
+        SendMessageInternal<schema::TextMsg>(client, static_cast<int>(dest), text);
+    }
+
+#ifdef HAS_MHOOKS_LIB
+    void SendTextMessage(const PlayerSet& clients, const HudPrint dest, const str::CStringView text)
+    {
+        if (MessageQueue::IsCollecting()) {
+            MessageQueue::Instance().PostTextMessage(clients, dest, text);
+            return;
         }
 
-        engine::MessageEnd();
+        SendMessageInternal<schema::TextMsg>(clients, static_cast<int>(dest), text);
     }
+#endif
+
+    void SendChatMessage(Edict* const client, const int sender, const str::CStringView text)
+    {
+#ifdef HAS_MHOOKS_LIB
+        if (MessageQueue::IsCollecting()) {
+            MessageQueue::Instance().PostChatMessage(Recipients(client), sender, text);
+            return;
+        }
+#endif
+
+        SendMessageInternal<schema::SayText>(client, sender, text);
+    }
+
+#ifdef HAS_MHOOKS_LIB
+    void SendChatMessage(const PlayerSet& clients, const int sender, const str::CStringView text)
+    {
+        if (MessageQueue::IsCollecting()) {
+            MessageQueue::Instance().PostChatMessage(clients, sender, text);
+            return;
+        }
+
+        SendMessageInternal<schema::SayText>(clients, sender, text);
+    }
+#endif
+
+    void SendChatColorMessage(Edict* const client, const str::CStringView text, const SayTextTeamColor color)
+    {
+        const auto client_index = engine::IndexOfEdict(client);
+        SendChatMessage(client, color == SayTextTeamColor::Default ? client_index : static_cast<int>(color), text);
+    }
+
+    void SendChatColorMessage(Edict* const client, const int sender, const str::CStringView text, const SayTextTeamColor color)
+    {
+        SendChatMessage(client, color == SayTextTeamColor::Default ? sender : static_cast<int>(color), text);
+    }
+
+#ifdef HAS_MHOOKS_LIB
+    void SendChatColorMessage(const PlayerSet& clients, const int sender, const str::CStringView text,
+                              const SayTextTeamColor color)
+    {
+        SendChatMessage(clients, color == SayTextTeamColor::Default ? sender : static_cast<int>(color), text);
+    }
+#endif
+
+    void SendHudMessage(Edict* const client, const HudTextParams& hud_params, const str::CStringView text)
+    {
+#ifdef HAS_MHOOKS_LIB
+        if (MessageQueue::IsCollecting()) {
+            MessageQueue::Instance().PostHudMessage(Recipients(client), hud_params, text);
+            return;
+        }
+#endif
+
+        HudTextString buffer;
+        WriteHudMessage(client, hud_params, PrepareHudPayload(hud_params, text, buffer));
+    }
+
+#ifdef HAS_MHOOKS_LIB
+    void SendHudMessage(const PlayerSet& clients, const HudTextParams& hud_params, const str::CStringView text)
+    {
+        if (MessageQueue::IsCollecting()) {
+            MessageQueue::Instance().PostHudMessage(clients, hud_params, text);
+            return;
+        }
+
+        const auto connected = PlayerSet::Connected();
+        const auto recipients = clients & connected;
+
+        if (recipients.Empty()) {
+            return;
+        }
+
+        HudTextString buffer;
+        const auto payload = PrepareHudPayload(hud_params, text, buffer);
+
+        if (recipients == connected) {
+            WriteHudMessage(nullptr, hud_params, payload);
+            return;
+        }
+
+        recipients.ForEach([&hud_params, &payload](const int index) {
+            WriteHudMessage(type_conversion::EdictByIndex(index), hud_params, payload);
+        });
+    }
+#endif
 }
 #endif
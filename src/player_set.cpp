@@ -0,0 +1,69 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if defined(HAS_METAMOD_LIB) && defined(HAS_MHOOKS_LIB)
+#include <core/player_set.h>
+#include <core/type_conversion.h>
+#include <algorithm>
+
+using namespace cssdk;
+
+namespace core
+{
+    PlayerSet PlayerSet::Connected()
+    {
+        // The sets are used by free message functions, so the type conversions are initialized on first use.
+        type_conversion::Init();
+
+        PlayerSet players{};
+        const auto max_clients = std::min(g_global_vars->max_clients, MAX_CLIENTS);
+
+        for (auto i = 1; i <= max_clients; ++i) {
+            if (const auto* const client = type_conversion::EdictByIndex(i);
+                IsValidEntity(client) && !(client->vars.flags & FL_FAKE_CLIENT)) {
+                players.Add(i);
+            }
+        }
+
+        return players;
+    }
+
+    void PlayerSet::Add(const Edict* const client)
+    {
+        assert(client != nullptr);
+        type_conversion::Init();
+        Add(type_conversion::IndexOfEntity(client));
+    }
+
+    void PlayerSet::Remove(const Edict* const client)
+    {
+        assert(client != nullptr);
+        type_conversion::Init();
+        Remove(type_conversion::IndexOfEntity(client));
+    }
+
+    bool PlayerSet::Contains(const Edict* const client) const
+    {
+        if (!client) {
+            return false;
+        }
+
+        type_conversion::Init();
+        return Contains(type_conversion::IndexOfEntity(client));
+    }
+}
+#endif
@@ -40,7 +40,7 @@ namespace
 #endif
 
     template <typename... Args>
-    void Error(const bool silent, const std::string& format, Args&&... args)
+    void Error(const bool silent, const str::CStringView format, Args&&... args)
     {
         if (!silent) {
             console::Message<false>(str::EMPTY); // Line feed
@@ -49,7 +49,7 @@ namespace
     }
 
     template <typename... Args>
-    void Message(const bool silent, const std::string& format, Args&&... args)
+    void Message(const bool silent, const str::CStringView format, Args&&... args)
     {
         if (!silent) {
             console::Message<false>(format, std::forward<Args>(args)...);
@@ -17,6 +17,284 @@
 
 #include <core/strings/examination.h>
 #include <core/strings/consts.h>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CORE_UTF8_SIMD
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define CORE_TARGET_SSE2
+#define CORE_TARGET_AVX2
+#define CORE_NO_SANITIZE_ADDRESS
+#else
+#define CORE_TARGET_SSE2 __attribute__((target("sse2")))
+#define CORE_TARGET_AVX2 __attribute__((target("avx2")))
+#define CORE_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#endif
+#endif
+
+namespace
+{
+    /**
+     * @brief Returns the length of the longest prefix of \c string, no longer than \c max_count,
+     * that was proven to consist of complete valid UTF-8 codepoints. The prefix always ends on a codepoint
+     * boundary, so the scalar validation can continue from there as if it had checked the prefix itself.
+    */
+    using SkipValidFunction = std::size_t (*)(const char* string, std::size_t max_count);
+
+    std::size_t SkipValidScalar(const char* const /*string*/, const std::size_t /*max_count*/)
+    {
+        return 0;
+    }
+
+#ifdef CORE_UTF8_SIMD
+    // The vector code classifies every byte of a block against the three bytes before it and applies the same rules
+    // as the scalar loop in Utf8Valid: a continuation byte is expected right after a lead byte, and only there;
+    // 0xC0 and 0xC1, leads above 0xF7 and the overlong 0xE0 0x80..0x9F and 0xF0 0x80..0x8F forms are rejected.
+    // Surrogates and codepoints above U+10FFFF are accepted, exactly as the scalar loop does.
+    //
+    // The vector code stops at the first block that contains a null-terminator, reaches beyond max_count or may
+    // hold an error, and leaves the rest to the scalar loop, so the returned position of an invalid codepoint
+    // is always computed by the scalar code.
+    //
+    // Vector loads are aligned, so they never cross a page boundary and cannot fault
+    // when the null-terminator is located before the end of the block.
+
+    /**
+     * @brief Bytes before the start of the string in the first block are replaced with spaces.
+     * A block loaded at offset 32 - N gives a mask that keeps the bytes from N onwards.
+    */
+    alignas(64) constexpr unsigned char KEEP_MASK[64]{
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+    /**
+     * @brief Returns the length of the validated prefix when the blocks before \c end were all checked.
+    */
+    std::size_t ValidatedPrefix(const char* const string, const char* const end)
+    {
+        // Step back to the lead byte of the last codepoint before the end.
+        const auto* lead = end - 1;
+
+        while (lead > string && 0x80 == (0xC0 & *lead)) {
+            --lead;
+        }
+
+        // A multibyte codepoint at the end is left to the scalar loop: it may continue in the unchecked block,
+        // and the scalar loop also checks the byte that follows it.
+        return static_cast<std::size_t>((0xC0 == (0xC0 & *lead) ? lead : end) - string);
+    }
+
+    /**
+     * @brief Returns \c a >= \c b for unsigned bytes.
+    */
+    CORE_TARGET_SSE2 __m128i GreaterEqualSse2(const __m128i a, const std::uint8_t b)
+    {
+        return _mm_cmpeq_epi8(_mm_max_epu8(a, _mm_set1_epi8(static_cast<char>(b))), a);
+    }
+
+    /**
+     * @brief Returns a non-zero bit mask if the block may contain an invalid codepoint.
+    */
+    CORE_TARGET_SSE2 unsigned ErrorMaskSse2(const __m128i previous, const __m128i current)
+    {
+        const auto prev1 = _mm_or_si128(_mm_slli_si128(current, 1), _mm_srli_si128(previous, 15));
+        const auto prev2 = _mm_or_si128(_mm_slli_si128(current, 2), _mm_srli_si128(previous, 14));
+        const auto prev3 = _mm_or_si128(_mm_slli_si128(current, 3), _mm_srli_si128(previous, 13));
+
+        const auto mask_c0 = _mm_set1_epi8(static_cast<char>(0xC0));
+        const auto mask_fe = _mm_set1_epi8(static_cast<char>(0xFE));
+        const auto byte_80 = _mm_set1_epi8(static_cast<char>(0x80));
+        const auto byte_e0 = _mm_set1_epi8(static_cast<char>(0xE0));
+        const auto byte_f0 = _mm_set1_epi8(static_cast<char>(0xF0));
+
+        const auto continuation = _mm_cmpeq_epi8(_mm_and_si128(current, mask_c0), byte_80);
+        const auto expected = _mm_or_si128(_mm_or_si128(GreaterEqualSse2(prev1, 0xC0), GreaterEqualSse2(prev2, 0xE0)),
+                                           GreaterEqualSse2(prev3, 0xF0));
+
+        const auto invalid_lead =
+            _mm_or_si128(GreaterEqualSse2(current, 0xF8), _mm_cmpeq_epi8(_mm_and_si128(current, mask_fe), mask_c0));
+
+        const auto overlong =
+            _mm_or_si128(_mm_andnot_si128(GreaterEqualSse2(current, 0xA0), _mm_cmpeq_epi8(prev1, byte_e0)),
+                         _mm_andnot_si128(GreaterEqualSse2(current, 0x90), _mm_cmpeq_epi8(prev1, byte_f0)));
+
+        const auto error = _mm_or_si128(_mm_xor_si128(continuation, expected), _mm_or_si128(invalid_lead, overlong));
+
+        return static_cast<unsigned>(_mm_movemask_epi8(error));
+    }
+
+    CORE_TARGET_SSE2 CORE_NO_SANITIZE_ADDRESS std::size_t SkipValidSse2(const char* const string, const std::size_t max_count)
+    {
+        constexpr std::size_t width = sizeof(__m128i);
+        const auto misalignment = static_cast<std::size_t>(reinterpret_cast<std::uintptr_t>(string) & (width - 1));
+        const auto* const first = string - misalignment;
+        const auto spaces = _mm_set1_epi8(' ');
+        const auto keep = _mm_loadu_si128(reinterpret_cast<const __m128i*>(KEEP_MASK + 32 - misalignment));
+
+        auto previous = spaces;
+        auto previous_ascii = true;
+        const auto* block = first;
+
+        for (; static_cast<std::size_t>(block + width - string) <= max_count; block += width) {
+            auto current = _mm_load_si128(reinterpret_cast<const __m128i*>(block));
+
+            if (block == first) {
+                current = _mm_or_si128(_mm_and_si128(keep, current), _mm_andnot_si128(keep, spaces));
+            }
+
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(current, _mm_setzero_si128())) != 0) {
+                break;
+            }
+
+            const auto ascii = _mm_movemask_epi8(current) == 0;
+
+            if ((!ascii || !previous_ascii) && ErrorMaskSse2(previous, current) != 0) {
+                break;
+            }
+
+            previous = current;
+            previous_ascii = ascii;
+        }
+
+        return block == first ? 0 : ValidatedPrefix(string, block);
+    }
+
+    /**
+     * @brief Returns \c a >= \c b for unsigned bytes.
+    */
+    CORE_TARGET_AVX2 __m256i GreaterEqualAvx2(const __m256i a, const std::uint8_t b)
+    {
+        return _mm256_cmpeq_epi8(_mm256_max_epu8(a, _mm256_set1_epi8(static_cast<char>(b))), a);
+    }
+
+    /**
+     * @brief Returns a non-zero bit mask if the block may contain an invalid codepoint.
+    */
+    CORE_TARGET_AVX2 unsigned ErrorMaskAvx2(const __m256i previous, const __m256i current)
+    {
+        // The high half of the previous block followed by the low half of the current one.
+        const auto shifted = _mm256_permute2x128_si256(previous, current, 0x21);
+        const auto prev1 = _mm256_alignr_epi8(current, shifted, 15);
+        const auto prev2 = _mm256_alignr_epi8(current, shifted, 14);
+        const auto prev3 = _mm256_alignr_epi8(current, shifted, 13);
+
+        const auto mask_c0 = _mm256_set1_epi8(static_cast<char>(0xC0));
+        const auto mask_fe = _mm256_set1_epi8(static_cast<char>(0xFE));
+        const auto byte_80 = _mm256_set1_epi8(static_cast<char>(0x80));
+        const auto byte_e0 = _mm256_set1_epi8(static_cast<char>(0xE0));
+        const auto byte_f0 = _mm256_set1_epi8(static_cast<char>(0xF0));
+
+        const auto continuation = _mm256_cmpeq_epi8(_mm256_and_si256(current, mask_c0), byte_80);
+        const auto expected = _mm256_or_si256(_mm256_or_si256(GreaterEqualAvx2(prev1, 0xC0), GreaterEqualAvx2(prev2, 0xE0)),
+                                              GreaterEqualAvx2(prev3, 0xF0));
+
+        const auto invalid_lead =
+            _mm256_or_si256(GreaterEqualAvx2(current, 0xF8), _mm256_cmpeq_epi8(_mm256_and_si256(current, mask_fe), mask_c0));
+
+        const auto overlong =
+            _mm256_or_si256(_mm256_andnot_si256(GreaterEqualAvx2(current, 0xA0), _mm256_cmpeq_epi8(prev1, byte_e0)),
+                            _mm256_andnot_si256(GreaterEqualAvx2(current, 0x90), _mm256_cmpeq_epi8(prev1, byte_f0)));
+
+        const auto error =
+            _mm256_or_si256(_mm256_xor_si256(continuation, expected), _mm256_or_si256(invalid_lead, overlong));
+
+        return static_cast<unsigned>(_mm256_movemask_epi8(error));
+    }
+
+    CORE_TARGET_AVX2 CORE_NO_SANITIZE_ADDRESS std::size_t SkipValidAvx2(const char* const string, const std::size_t max_count)
+    {
+        constexpr std::size_t width = sizeof(__m256i);
+        const auto misalignment = static_cast<std::size_t>(reinterpret_cast<std::uintptr_t>(string) & (width - 1));
+        const auto* const first = string - misalignment;
+        const auto spaces = _mm256_set1_epi8(' ');
+        const auto keep = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(KEEP_MASK + 32 - misalignment));
+
+        auto previous = spaces;
+        auto previous_ascii = true;
+        const auto* block = first;
+
+        for (; static_cast<std::size_t>(block + width - string) <= max_count; block += width) {
+            auto current = _mm256_load_si256(reinterpret_cast<const __m256i*>(block));
+
+            if (block == first) {
+                current = _mm256_or_si256(_mm256_and_si256(keep, current), _mm256_andnot_si256(keep, spaces));
+            }
+
+            if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(current, _mm256_setzero_si256())) != 0) {
+                break;
+            }
+
+            const auto ascii = _mm256_movemask_epi8(current) == 0;
+
+            if ((!ascii || !previous_ascii) && ErrorMaskAvx2(previous, current) != 0) {
+                break;
+            }
+
+            previous = current;
+            previous_ascii = ascii;
+        }
+
+        return block == first ? 0 : ValidatedPrefix(string, block);
+    }
+
+    bool CpuSupportsSse2()
+    {
+#ifdef _MSC_VER
+        int info[4]{};
+        __cpuid(info, 1);
+
+        return (info[3] & (1 << 26)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse2");
+#endif
+    }
+
+    bool CpuSupportsAvx2()
+    {
+#ifdef _MSC_VER
+        int info[4]{};
+        __cpuid(info, 0);
+
+        if (info[0] < 7) {
+            return false;
+        }
+
+        // AVX and OSXSAVE, the OS must also save the YMM registers on context switch.
+        __cpuid(info, 1);
+
+        if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 0x6) != 0x6) {
+            return false;
+        }
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif
+
+    SkipValidFunction ResolveSkipValid()
+    {
+#ifdef CORE_UTF8_SIMD
+        if (CpuSupportsAvx2()) {
+            return &SkipValidAvx2;
+        }
+
+        if (CpuSupportsSse2()) {
+            return &SkipValidSse2;
+        }
+#endif
+        return &SkipValidScalar;
+    }
+}
 
 namespace core::str
 {
@@ -24,9 +302,13 @@ namespace core::str
     {
         assert(string != nullptr);
 
+        static const auto skip_valid = ResolveSkipValid();
         const auto* const s = string;
         std::size_t consumed{};
 
+        // Skip the valid prefix with vector code, the scalar loop checks the rest.
+        string += skip_valid(string, count);
+
         while ((void)(consumed = static_cast<std::size_t>(string - s)), consumed < count && EOS != *string) {
             if (const auto remained = count - consumed; 0xF0 == (0xF8 & *string)) {
                 // ensure that there's 4 bytes or more remained
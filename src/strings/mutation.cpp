@@ -23,19 +23,37 @@ namespace core::str
 {
     std::string Utf8Truncate(const std::string& string, const std::string::size_type max_size)
     {
-        if (string.empty() || string.size() <= max_size) {
-            return string;
+        return string.substr(0, Utf8TruncatedSize(string, max_size));
+    }
+
+    std::size_t Utf8TruncatedSize(const std::string_view string, const std::size_t max_size)
+    {
+        if (string.size() <= max_size) {
+            return string.size();
         }
 
         if (max_size == 0) {
-            return std::string{};
+            return 0;
+        }
+
+        const auto* const data = string.data();
+        const auto* const invalid_ptr = Utf8Valid(data, max_size);
+
+        return invalid_ptr == nullptr ? max_size : static_cast<std::size_t>(invalid_ptr - data);
+    }
+
+    std::size_t Utf8TruncateInPlace(char* const string, const std::size_t length, const std::size_t max_size)
+    {
+        assert(string != nullptr);
+
+        if (length <= max_size) {
+            return length;
         }
 
-        const auto* c_str = string.c_str();
-        const auto* invalid_ptr = Utf8Valid(c_str, max_size);
-        const std::string::size_type invalid_pos = invalid_ptr - c_str;
+        const auto new_length = Utf8TruncatedSize({string, length}, max_size);
+        string[new_length] = EOS;
 
-        return invalid_pos == 0 ? string : string.substr(0, invalid_pos);
+        return new_length;
     }
 
     void ReplaceAll(char* string, const char what, const char with)
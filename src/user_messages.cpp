@@ -0,0 +1,112 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAS_METAMOD_LIB
+#include <core/user_messages.h>
+#include <metamod/utils.h>
+#include <cassert>
+
+#ifdef HAS_MHOOKS_LIB
+#include <mhooks/metamod.h>
+#endif
+
+using namespace core;
+using namespace cssdk;
+using namespace metamod;
+using namespace core::messages;
+using namespace core::messages::detail;
+
+#ifdef HAS_MHOOKS_LIB
+using namespace mhooks;
+#endif
+
+namespace
+{
+    constexpr std::array<const char*, static_cast<std::size_t>(UserMsg::Count)> USER_MSG_NAMES = {
+        "TextMsg",
+        "SayText",
+        "ShowMenu"};
+
+    /**
+     * @brief Returns the value stored in the registry for the resolved message ID.
+    */
+    int RegistryValue(const int id)
+    {
+#ifdef HAS_MHOOKS_LIB
+        // The IDs are resolved again at ServerActivate; until then, do not search for an unregistered message.
+        return id > 0 ? id : -1;
+#else
+        // Without the ServerActivate hook, an unregistered message is searched again on each use.
+        return id > 0 ? id : 0;
+#endif
+    }
+
+#ifdef HAS_MHOOKS_LIB
+    void OnServerActivate(const GameDllServerActivateMChain& chain, Edict* const edicts, const int edict_count,
+                          const int max_clients)
+    {
+        // The game registers its user messages while precaching, before ServerActivate.
+        ResolveUserMessages();
+        chain.CallNext(edicts, edict_count, max_clients);
+    }
+#endif
+
+    void InstallHooks()
+    {
+#ifdef HAS_MHOOKS_LIB
+        static auto installed = false;
+
+        if (installed) {
+            return;
+        }
+
+        installed = true;
+        MHookGameDllServerActivate(DELEGATE_ARG<OnServerActivate>, false, HookChainPriority::Uninterruptable);
+#endif
+    }
+}
+
+namespace core::messages
+{
+    void ResolveUserMessages()
+    {
+        InstallHooks();
+
+        for (std::size_t i = 0; i < USER_MSG_NAMES.size(); ++i) {
+            user_msg_ids[i] = RegistryValue(utils::GetUserMsgId(USER_MSG_NAMES[i]));
+        }
+    }
+
+    const char* UserMsgName(const UserMsg message)
+    {
+        assert(message < UserMsg::Count);
+        return USER_MSG_NAMES[static_cast<std::size_t>(message)];
+    }
+
+    int detail::ResolveUserMsgId(const UserMsg message)
+    {
+        assert(message < UserMsg::Count);
+        InstallHooks();
+
+        // Resolve only the requested message, the game may not have registered the others yet.
+        const auto id = utils::GetUserMsgId(USER_MSG_NAMES[static_cast<std::size_t>(message)]);
+        user_msg_ids[static_cast<std::size_t>(message)] = RegistryValue(id);
+
+        return id > 0 ? id : 0;
+    }
+}
+#endif
@@ -0,0 +1,126 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "test.h"
+#include <core/concurrent_observer.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr std::uint32_t ALIVE = 0xA11CE;
+    constexpr std::uint32_t DESTROYED = 0xDEAD;
+
+    class TestObservable : public core::ConcurrentObservable<int>
+    {
+    public:
+        using ConcurrentObservable::Notify;
+        using ConcurrentObservable::Post;
+    };
+
+    /**
+     * @brief Captured by the observers; calling an observer from a freed snapshot finds it destroyed.
+    */
+    struct Probe
+    {
+        std::uint32_t state{ALIVE};
+
+        Probe() = default;
+        Probe(const Probe&) = default;
+        Probe& operator=(const Probe&) = default;
+
+        ~Probe()
+        {
+            state = DESTROYED;
+        }
+    };
+}
+
+int main()
+{
+    constexpr int events_per_worker = 20'000;
+    const auto worker_count = std::max(2U, std::thread::hardware_concurrency() - 1);
+
+    TestObservable observable{};
+    std::atomic<std::uint64_t> delivered{};
+    std::atomic<unsigned> finished_workers{};
+
+    // Permanent observer: counts the posted events delivered on the game thread.
+    const auto permanent = observable.Subscribe([&delivered, probe = Probe{}](const int value) {
+        CORE_CHECK(probe.state == ALIVE);
+
+        if (value >= 0) {
+            delivered.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    std::vector<std::thread> workers{};
+
+    for (unsigned i = 0; i < worker_count; ++i) {
+        workers.emplace_back([&] {
+            for (auto n = 0; n < events_per_worker; ++n) {
+                // Negative values are notified directly on the worker, the others are posted to the game thread.
+                observable.Notify(-1);
+                CORE_CHECK(observable.IsSubscribed(permanent.Id()));
+                CORE_CHECK(observable.Size() >= 1);
+
+                // A full queue drops the event, post it again after the game thread dispatched.
+                while (!observable.Post(n)) {
+                    std::this_thread::yield();
+                }
+
+                // Tokens are created and dropped on the workers too.
+                if (n % 64 == 0) {
+                    const auto token = observable.Subscribe([probe = Probe{}](const int) { CORE_CHECK(probe.state == ALIVE); });
+                    CORE_CHECK(observable.IsSubscribed(token.Id()));
+                }
+            }
+
+            finished_workers.fetch_add(1);
+        });
+    }
+
+    // The game thread churns the observers and dispatches the posted events.
+    std::vector<core::Subscription> churn{};
+
+    while (finished_workers.load() < worker_count) {
+        churn.push_back(observable.Subscribe([probe = Probe{}](const int) { CORE_CHECK(probe.state == ALIVE); }));
+
+        if (churn.size() > 16) {
+            const auto id = churn.front().Id();
+            churn.erase(churn.begin());
+            CORE_CHECK(!observable.IsSubscribed(id));
+        }
+
+        observable.Dispatch();
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    while (observable.Dispatch() != 0) {
+    }
+
+    CORE_CHECK(delivered.load() == static_cast<std::uint64_t>(worker_count) * events_per_worker);
+    CORE_CHECK(observable.Size() == churn.size() + 1);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,168 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "test.h"
+
+#ifdef HAS_METAMOD_LIB
+#include <core/localization.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr int LABEL_COUNT = 512;
+    constexpr const char* LANGUAGES[] = {"en", "ru"};
+
+    /**
+     * @brief Returns the text of the label in the dictionary of the specified generation.
+     * The length varies with the generation, so the texts of two dictionaries are laid out differently.
+    */
+    std::string ExpectedText(const std::uint32_t generation, const std::string_view lang, const int label)
+    {
+        std::string text{lang};
+        text.append(" ").append(std::to_string(generation)).append(" ").append(std::to_string(label)).append(" ");
+        text.append(static_cast<std::size_t>((generation * 7 + static_cast<std::uint32_t>(label)) % 61 + 1), 'x');
+
+        return text;
+    }
+
+    /**
+     * @brief Writes the dictionary of the specified generation and renames it over the file,
+     * so a reload never sees a partially written file.
+    */
+    void WriteDictionary(const std::filesystem::path& path, const std::uint32_t generation)
+    {
+        auto temp_path = path;
+        temp_path += ".tmp";
+
+        {
+            std::ofstream file{temp_path, std::ios::trunc};
+
+            for (const auto* const lang : LANGUAGES) {
+                file << '[' << lang << "]\n";
+
+                for (auto label = 0; label < LABEL_COUNT; ++label) {
+                    file << "LABEL_" << label << " = " << ExpectedText(generation, lang, label) << '\n';
+                }
+            }
+        }
+
+        std::filesystem::rename(temp_path, path);
+    }
+
+    /**
+     * @brief Checks that the text is the text of the label in one complete dictionary
+     * and returns the generation of that dictionary.
+    */
+    std::uint32_t CheckText(const core::str::CStringView text, const std::string_view lang, const int label)
+    {
+        CORE_CHECK(text.c_str() != nullptr);
+        CORE_CHECK(std::string_view{text.c_str()}.length() == text.length());
+
+        const std::string_view view{text.c_str(), text.length()};
+        CORE_CHECK(view.substr(0, lang.length()) == lang);
+
+        const auto generation = static_cast<std::uint32_t>(std::strtoul(view.data() + lang.length() + 1, nullptr, 10));
+        CORE_CHECK(view == ExpectedText(generation, lang, label));
+
+        return generation;
+    }
+}
+
+int main()
+{
+    constexpr std::uint32_t generations = 300;
+    constexpr int reader_count = 3;
+
+    const auto path = std::filesystem::temp_directory_path() / "core_localization_reload_test.txt";
+    WriteDictionary(path, 0);
+
+    core::Localization localization{path.string()};
+    constexpr core::LocLabel static_label{"LABEL_7"};
+    const auto resolved_label = localization.Resolve("LABEL_511");
+
+    std::atomic<bool> stop{};
+    std::atomic<std::uint64_t> reads{};
+    std::vector<std::thread> readers{};
+
+    for (auto i = 0; i < reader_count; ++i) {
+        readers.emplace_back([&, i] {
+            std::uint32_t last_generation{};
+            const std::string lang{LANGUAGES[i % 2]};
+
+            for (auto n = 0; !stop.load(); ++n) {
+                const auto scope = localization.Pin();
+                const auto label = n % LABEL_COUNT;
+
+                // Each call may see a newer dictionary, but never an older one or a mix of two.
+                const auto by_text = CheckText(localization.GetText(lang, "LABEL_" + std::to_string(label)), lang, label);
+                CORE_CHECK(by_text >= last_generation);
+
+                const auto by_static = CheckText(localization.GetText(lang, static_label), lang, 7);
+                CORE_CHECK(by_static >= by_text);
+
+                const auto by_resolved = CheckText(localization.GetText(lang, resolved_label), lang, LABEL_COUNT - 1);
+                CORE_CHECK(by_resolved >= by_static);
+
+                last_generation = by_resolved;
+                reads.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    // The game thread: reload in the background and publish at the start of a frame.
+    for (std::uint32_t generation = 1; generation <= generations; ++generation) {
+        WriteDictionary(path, generation);
+        CORE_CHECK(localization.ReloadAsync());
+
+        while (!localization.Update()) {
+            CheckText(localization.GetText("en", static_label), "en", 7);
+            std::this_thread::yield();
+        }
+
+        CORE_CHECK(CheckText(localization.GetText("en", resolved_label), "en", LABEL_COUNT - 1) == generation);
+    }
+
+    // Let the readers run against the last dictionary too.
+    while (reads.load() < 10'000) {
+        std::this_thread::yield();
+    }
+
+    stop.store(true);
+
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    std::filesystem::remove(path);
+    return EXIT_SUCCESS;
+}
+#else
+int main()
+{
+    // Localization is only built with metamod.
+    return CORE_SKIP_TEST;
+}
+#endif
@@ -0,0 +1,183 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "test.h"
+#include <core/observer.h>
+#include <cstddef>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    class TestObservable : public core::Observable<int>
+    {
+    public:
+        using Observable::Notify;
+    };
+
+    /**
+     * @brief Subscribes, unsubscribes and notifies at random, also from the observers, and checks the observable
+     * against a model of the subscriptions.
+    */
+    class Harness
+    {
+        TestObservable observable_{};
+        std::vector<std::pair<int, core::Subscription>> alive_{};
+        std::unordered_set<int> alive_keys_{};
+        std::unordered_set<int> pending_keys_{};
+        std::vector<core::SubscriptionId> removed_ids_{};
+        std::vector<std::unordered_map<int, int>> frames_{};
+        std::mt19937 random_{20201017}; // NOLINT(cert-msc51-cpp)
+        int next_key_{};
+
+    public:
+        void Add()
+        {
+            const auto key = next_key_++;
+            alive_.emplace_back(key, observable_.Subscribe([this, key](const int) { OnCall(key); }));
+            alive_keys_.insert(key);
+
+            // Observers subscribed during a notification must not be called until the next one.
+            if (!frames_.empty()) {
+                pending_keys_.insert(key);
+            }
+        }
+
+        void Remove(const std::size_t index)
+        {
+            auto& [key, subscription] = alive_[index];
+            removed_ids_.push_back(subscription.Id());
+            alive_keys_.erase(key);
+            subscription.Reset();
+
+            alive_[index] = std::move(alive_.back());
+            alive_.pop_back();
+        }
+
+        void RemoveRandom()
+        {
+            if (!alive_.empty()) {
+                Remove(std::uniform_int_distribution<std::size_t>{0, alive_.size() - 1}(random_));
+            }
+        }
+
+        void RemoveKey(const int key)
+        {
+            for (std::size_t i = 0; i < alive_.size(); ++i) {
+                if (alive_[i].first == key) {
+                    Remove(i);
+                    return;
+                }
+            }
+        }
+
+        void Notify()
+        {
+            std::unordered_set<int> expected{};
+
+            for (const auto key : alive_keys_) {
+                if (pending_keys_.count(key) == 0) {
+                    expected.insert(key);
+                }
+            }
+
+            frames_.emplace_back();
+            observable_.Notify(static_cast<int>(frames_.size()));
+
+            // Every observer subscribed before the notification is called once, unless it was unsubscribed.
+            for (const auto& [key, calls] : frames_.back()) {
+                CORE_CHECK(expected.count(key) == 1);
+                CORE_CHECK(calls == 1);
+            }
+
+            for (const auto key : expected) {
+                if (alive_keys_.count(key) != 0) {
+                    CORE_CHECK(frames_.back().count(key) == 1);
+                }
+            }
+
+            frames_.pop_back();
+
+            if (frames_.empty()) {
+                pending_keys_.clear();
+                Check();
+            }
+        }
+
+        void Check() const
+        {
+            CORE_CHECK(observable_.Size() == alive_.size());
+
+            for (const auto& [key, subscription] : alive_) {
+                CORE_CHECK(observable_.IsSubscribed(subscription.Id()));
+            }
+
+            for (const auto id : removed_ids_) {
+                CORE_CHECK(!observable_.IsSubscribed(id));
+            }
+        }
+
+        void Frame()
+        {
+            // Keep about 300 subscribers between the frames.
+            while (alive_.size() < 300) {
+                Add();
+            }
+
+            Notify();
+            removed_ids_.clear();
+        }
+
+    private:
+        void OnCall(const int key)
+        {
+            CORE_CHECK(!frames_.empty());
+            CORE_CHECK(alive_keys_.count(key) == 1);
+            CORE_CHECK(pending_keys_.count(key) == 0);
+            CORE_CHECK(observable_.Size() == alive_.size());
+
+            ++frames_.back()[key];
+
+            if (const auto action = random_() % 100; action < 10) {
+                RemoveRandom();
+            }
+            else if (action < 20) {
+                Add();
+            }
+            else if (action < 23) {
+                RemoveKey(key);
+            }
+            else if (action < 24 && frames_.size() < 3) {
+                Notify();
+            }
+        }
+    };
+}
+
+int main()
+{
+    Harness harness{};
+
+    for (auto frame = 0; frame < 2000; ++frame) {
+        harness.Frame();
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,170 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "test.h"
+#include <core/rcu.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr std::uint64_t ALIVE = 0xA11CE;
+    constexpr std::uint64_t FREED = 0xDEAD;
+
+    std::atomic<int> live_snapshots{};
+
+    /**
+     * @brief Memory of the freed snapshots is kept for a while, so a reader of a freed snapshot sees \c FREED
+     * instead of a new snapshot allocated at the same address. Snapshots are freed only on the writer thread.
+    */
+    struct Quarantine
+    {
+        std::deque<void*> memory{};
+
+        ~Quarantine()
+        {
+            for (auto* const block : memory) {
+                ::operator delete(block);
+            }
+        }
+    } quarantine{};
+
+    /**
+     * @brief Published value whose fields are only consistent while it is alive.
+    */
+    struct Snapshot
+    {
+        std::atomic<std::uint64_t> state{ALIVE};
+        std::uint64_t serial{};
+        std::uint64_t check{};
+        std::vector<std::uint64_t> values{};
+
+        explicit Snapshot(const std::uint64_t serial)
+            : serial(serial), check(~serial), values(serial % 64 + 1, serial)
+        {
+            live_snapshots.fetch_add(1);
+        }
+
+        ~Snapshot()
+        {
+            state.store(FREED);
+            live_snapshots.fetch_sub(1);
+        }
+
+        static void* operator new(const std::size_t size)
+        {
+            return ::operator new(size);
+        }
+
+        static void operator delete(void* const memory, std::size_t)
+        {
+            quarantine.memory.push_back(memory);
+
+            if (quarantine.memory.size() > 4096) {
+                ::operator delete(quarantine.memory.front());
+                quarantine.memory.pop_front();
+            }
+        }
+
+        Snapshot(const Snapshot&) = delete;
+        Snapshot(Snapshot&&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+        Snapshot& operator=(Snapshot&&) = delete;
+    };
+
+    /**
+     * @brief Checks that the snapshot is alive and not torn.
+    */
+    void CheckSnapshot(const Snapshot* const snapshot)
+    {
+        CORE_CHECK(snapshot != nullptr);
+        CORE_CHECK(snapshot->state.load() == ALIVE);
+        CORE_CHECK(snapshot->check == ~snapshot->serial);
+        CORE_CHECK(snapshot->values.size() == snapshot->serial % 64 + 1);
+
+        for (const auto value : snapshot->values) {
+            CORE_CHECK(value == snapshot->serial);
+        }
+    }
+}
+
+int main()
+{
+    constexpr std::uint64_t publications = 100'000;
+    constexpr std::uint64_t min_reads = 1'000'000;
+    const auto reader_count = std::max(2U, std::thread::hardware_concurrency() - 1);
+
+    core::RcuCell<Snapshot> cell{std::make_unique<const Snapshot>(0)};
+    std::atomic<bool> stop{};
+    std::atomic<std::uint64_t> reads{};
+    std::vector<std::thread> readers{};
+
+    for (unsigned i = 0; i < reader_count; ++i) {
+        readers.emplace_back([&cell, &stop, &reads, i] {
+            std::uint64_t last_serial{};
+
+            for (std::uint64_t n = 0; !stop.load(); ++n) {
+                const auto scope = cell.Pin();
+                const auto* const snapshot = cell.Load();
+
+                CheckSnapshot(snapshot);
+                CORE_CHECK(snapshot->serial >= last_serial);
+                last_serial = snapshot->serial;
+                reads.fetch_add(1, std::memory_order_relaxed);
+
+                // Some readers hold the pin for a while, so that grace periods overlap.
+                if ((n + i) % 64 == 0) {
+                    std::this_thread::yield();
+                    CheckSnapshot(snapshot);
+                }
+            }
+        });
+    }
+
+    // Publish until the readers had enough time to overlap the writer, even on a single core.
+    for (std::uint64_t serial = 1; serial <= publications || reads.load() < min_reads; ++serial) {
+        cell.Publish(std::make_unique<const Snapshot>(serial));
+        CheckSnapshot(cell.Current());
+
+        if (serial % 4 == 0) {
+            cell.Reclaim();
+        }
+
+        if (serial % 256 == 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    stop.store(true);
+
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    // With no readers left, the retired values are freed within two grace periods.
+    cell.Reclaim();
+    CORE_CHECK(!cell.Reclaim());
+    CORE_CHECK(live_snapshots.load() == 1);
+
+    return EXIT_SUCCESS;
+}
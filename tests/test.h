@@ -0,0 +1,38 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * @brief Prints the failed condition and terminates the test with a non-zero exit code.
+*/
+#define CORE_CHECK(condition)                                                                              \
+    do {                                                                                                   \
+        if (!(condition)) {                                                                                \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);             \
+            std::exit(EXIT_FAILURE);                                                                       \
+        }                                                                                                  \
+    }                                                                                                      \
+    while (false)
+
+/**
+ * @brief Exit code of a test that cannot run in this build configuration; ctest reports it as skipped.
+*/
+#define CORE_SKIP_TEST 77
@@ -0,0 +1,69 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace core::test
+{
+    /**
+     * @brief The plain scalar UTF-8 validator that str::Utf8Valid must match byte for byte.
+    */
+    inline const char* Utf8ValidReference(const char* string, const std::size_t count = SIZE_MAX)
+    {
+        const auto* const s = string;
+        std::size_t consumed{};
+
+        while ((void)(consumed = static_cast<std::size_t>(string - s)), consumed < count && '\0' != *string) {
+            if (const auto remained = count - consumed; 0xF0 == (0xF8 & *string)) {
+                if (remained < 4 || (0x80 != (0xC0 & string[1])) || (0x80 != (0xC0 & string[2])) ||
+                    (0x80 != (0xC0 & string[3])) || (0x80 == (0xC0 & string[4])) ||
+                    ((0 == (0x07 & string[0])) && (0 == (0x30 & string[1])))) {
+                    return string;
+                }
+
+                string += 4;
+            }
+            else if (0xE0 == (0xF0 & *string)) {
+                if (remained < 3 || (0x80 != (0xC0 & string[1])) || (0x80 != (0xC0 & string[2])) ||
+                    (0x80 == (0xC0 & string[3])) || ((0 == (0x0F & string[0])) && (0 == (0x20 & string[1])))) {
+                    return string;
+                }
+
+                string += 3;
+            }
+            else if (0xC0 == (0xE0 & *string)) {
+                if (remained < 2 || (0x80 != (0xC0 & string[1])) || (0x80 == (0xC0 & string[2])) ||
+                    (0 == (0x1E & string[0]))) {
+                    return string;
+                }
+
+                string += 2;
+            }
+            else if (0x00 == (0x80 & *string)) {
+                string += 1;
+            }
+            else {
+                return string;
+            }
+        }
+
+        return nullptr;
+    }
+}
@@ -0,0 +1,108 @@
+/*
+ *  Copyright (C) 2020 the_hunter
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "test.h"
+#include "utf8_valid_reference.h"
+#include <core/strings/examination.h>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using core::str::Utf8Valid;
+    using core::test::Utf8ValidReference;
+
+    // Fragments the random strings are assembled from: valid codepoints of every length
+    // and the malformed sequences the validator must reject.
+    const std::vector<std::string> FRAGMENTS{
+        "a", "Z", " ", "!", "0", "\x7F",                                    // ASCII
+        "\xD0\x9F", "\xD1\x80", "\xD0\xB8", "\xC2\xA9", "\xDF\xBF",         // 2-byte: Cyrillic, Latin-1
+        "\xE2\x82\xAC", "\xE0\xA0\x80", "\xEF\xBF\xBF", "\xED\xA0\x80",     // 3-byte, surrogates included
+        "\xF0\x9F\x98\x80", "\xF0\x90\x80\x80", "\xF4\x8F\xBF\xBF",         // 4-byte: emoji and the edges
+        "\xF7\xBF\xBF\xBF",                                                 // above U+10FFFF, accepted as before
+        "\x80", "\xBF", "\xF8", "\xFF", "\xC0\x80", "\xC1\xBF",             // stray continuation, invalid leads
+        "\xE0\x80\x80", "\xE0\x9F\xBF", "\xF0\x80\x80\x80", "\xF0\x8F\xBF", // overlong
+        "\xD0", "\xE2\x82", "\xF0\x9F\x98",                                 // truncated
+        "\xD0\x9F\x80", "\xE2\x82\xAC\x80",                                 // too long
+    };
+
+    std::string RandomString(std::mt19937& random, const std::size_t fragments, const bool valid_only)
+    {
+        // The first 19 fragments are valid.
+        std::uniform_int_distribution<std::size_t> pick{0, valid_only ? 18 : FRAGMENTS.size() - 1};
+        std::string result{};
+
+        for (std::size_t i = 0; i < fragments; ++i) {
+            result += FRAGMENTS[pick(random)];
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Checks the string at every alignment, with and without a count limit.
+    */
+    void CheckAgainstReference(const std::string& text, std::mt19937& random)
+    {
+        constexpr std::size_t max_offset = 64;
+        std::vector<char> buffer(max_offset + text.size() + 8, '\0');
+        std::uniform_int_distribution<std::size_t> pick_count{0, text.size() + 1};
+
+        for (std::size_t offset = 0; offset < max_offset; ++offset) {
+            auto* const string = buffer.data() + offset;
+            text.copy(string, text.size());
+            string[text.size()] = '\0';
+
+            CORE_CHECK(Utf8Valid(string) == Utf8ValidReference(string));
+            CORE_CHECK(Utf8Valid(string, text.size()) == Utf8ValidReference(string, text.size()));
+
+            // A count that cuts the string, the bytes after it are not null-terminators.
+            const auto count = pick_count(random);
+            string[text.size()] = 'x';
+            string[text.size() + 1] = '\0';
+            CORE_CHECK(Utf8Valid(string, count) == Utf8ValidReference(string, count));
+
+            std::fill(string, string + text.size() + 2, '\0');
+        }
+    }
+}
+
+int main()
+{
+    std::mt19937 random{20201017}; // NOLINT(cert-msc51-cpp)
+    std::uniform_int_distribution<std::size_t> pick_length{0, 120};
+
+    CORE_CHECK(Utf8Valid("") == nullptr);
+    CORE_CHECK(Utf8Valid("\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82") == nullptr);
+
+    for (auto i = 0; i < 20000; ++i) {
+        // Mostly valid text, so the vector path runs far before it hits an error.
+        const auto valid_only = i % 4 != 0;
+        auto text = RandomString(random, pick_length(random), valid_only);
+
+        if (valid_only && i % 8 == 1 && !text.empty()) {
+            // A single malformed byte somewhere in a long valid text.
+            text[std::uniform_int_distribution<std::size_t>{0, text.size() - 1}(random)] = static_cast<char>(random());
+        }
+
+        CheckAgainstReference(text, random);
+    }
+
+    return EXIT_SUCCESS;
+}